@@ -8,11 +8,17 @@
 #ifndef SABER_BUMP_BUMP_H_
 #define SABER_BUMP_BUMP_H_
 
+#include <mpi.h>
+
 #include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <exception>
 #include <fstream>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -110,6 +116,9 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<eckit::LocalConfiguration> ensemble1{"ensemble", this};
   // Ensemble 2 parameters
   oops::OptionalParameter<eckit::LocalConfiguration> ensemble2{"lowres ensemble", this};
+  // Number of ensemble members read ahead on a background thread (0 for sequential reading,
+  // requires MPI_THREAD_MULTIPLE and geometries on a duplicated communicator for the reads)
+  oops::OptionalParameter<int> ensemblePrefetch{"ensemble prefetch", this};
   // Missing value (real)
   oops::OptionalParameter<double> msvalr{"msvalr", this};
   // Grids
@@ -139,6 +148,8 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<bool> colorlog{"colorlog", this};
   // Default seed for random numbers
   oops::OptionalParameter<bool> default_seed{"default_seed", this};
+  // Counter-based random numbers (decomposition-independent)
+  oops::OptionalParameter<bool> counter_rng{"counter_rng", this};
   // Inter-compilers reproducibility
   oops::OptionalParameter<bool> repro{"repro", this};
   // Reproducibility threshold
@@ -193,6 +204,16 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<bool> load_mom{"load_mom", this};
   // Write sampling moments
   oops::OptionalParameter<bool> write_mom{"write_mom", this};
+  // Sampling moments checkpoint period for update_mom, in members (0 for none)
+  oops::OptionalParameter<int> mom_checkpoint{"mom_checkpoint", this};
+  // Resume the sequential update of sampling moments from a checkpoint
+  oops::OptionalParameter<bool> load_mom_checkpoint{"load_mom_checkpoint", this};
+  // First member accumulated by update_mom
+  oops::OptionalParameter<int> mom_ie_first{"mom_ie_first", this};
+  // Last member accumulated by update_mom (0 for the ensemble size)
+  oops::OptionalParameter<int> mom_ie_last{"mom_ie_last", this};
+  // Merge sampling moments checkpoints from disjoint subsets of members
+  oops::OptionalParameter<bool> merge_mom{"merge_mom", this};
   // Compute new HDIAG diagnostics
   oops::OptionalParameter<bool> new_hdiag{"new_hdiag", this};
   // Write HDIAG diagnostics
@@ -207,6 +228,8 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<bool> write_nicas_local{"write_nicas_local", this};
   // Write global NICAS parameters
   oops::OptionalParameter<bool> write_nicas_global{"write_nicas_global", this};
+  // Use the binary NICAS cache for local NICAS parameters
+  oops::OptionalParameter<bool> nicas_cache{"nicas_cache", this};
   // Compute wind transform
   oops::OptionalParameter<bool> new_wind{"new_wind", this};
   // Load local wind transform
@@ -235,6 +258,8 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<bool> check_set_param{"check_set_param", this};
   // Test get_parameter interface
   oops::OptionalParameter<bool> check_get_param{"check_get_param", this};
+  // Test incremental NICAS update interface
+  oops::OptionalParameter<bool> check_update_nicas{"check_update_nicas", this};
   // Test apply_vbal interfaces
   oops::OptionalParameter<bool> check_apply_vbal{"check_apply_vbal", this};
   // Test apply_stddev interfaces
@@ -254,6 +279,10 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<std::string> fname_vbal{"fname_vbal", this};
   // Moments files
   oops::OptionalParameter<std::vector<std::string>> fname_mom{"fname_mom", this};
+  // Moments checkpoint file
+  oops::OptionalParameter<std::string> fname_mom_checkpoint{"fname_mom_checkpoint", this};
+  // Moments checkpoint files to merge
+  oops::OptionalParameter<std::vector<std::string>> fname_mom_merge{"fname_mom_merge", this};
   // NICAS file
   oops::OptionalParameter<std::string> fname_nicas{"fname_nicas", this};
   // Wind transform file
@@ -372,6 +401,8 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<int> vbal_pseudo_inv_mmax{"vbal_pseudo_inv_mmax", this};
   // Variance threshold to compute the dominant mode for pseudo-inverse
   oops::OptionalParameter<double> vbal_pseudo_inv_var_th{"vbal_pseudo_inv_var_th", this};
+  // Precompute interpolated regressions on subset Sc0
+  oops::OptionalParameter<bool> vbal_precomp{"vbal_precomp", this};
   // Force specific variance
   oops::OptionalParameter<bool> forced_var{"forced_var", this};
   // Forced standard-deviation
@@ -432,6 +463,16 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<bool> pos_def_test{"pos_def_test", this};
   // Write NICAS grids
   oops::OptionalParameter<bool> write_nicas_grids{"write_nicas_grids", this};
+  // Single precision storage for NICAS coefficients and halo buffers
+  oops::OptionalParameter<bool> nicas_single_precision{"nicas_single_precision", this};
+  // Keep NICAS geometry data for incremental support radii updates
+  oops::OptionalParameter<bool> nicas_incremental{"nicas_incremental", this};
+  // Stochastic estimate of the NICAS normalization
+  oops::OptionalParameter<bool> nicas_norm_stochastic{"nicas_norm_stochastic", this};
+  // Maximum number of random vectors for the stochastic NICAS normalization
+  oops::OptionalParameter<int> nicas_norm_nsamples{"nicas_norm_nsamples", this};
+  // Target relative accuracy of the stochastic NICAS normalization
+  oops::OptionalParameter<double> nicas_norm_accuracy{"nicas_norm_accuracy", this};
 
   // dirac_param
 
@@ -481,6 +522,107 @@ template <typename MODEL> class BUMP_Parameters : public oops::Parameters {
   oops::OptionalParameter<double> wind_inflation{"wind_inflation", this};
 };
 
+// -----------------------------------------------------------------------------
+/// Ensemble members reader. With nPrefetch > 0, the members are read in order on a background
+/// thread, at most nPrefetch members ahead of the member being processed, so that nPrefetch+1
+/// increments are allocated at most. The model read is collective and runs concurrently with
+/// the BUMP collectives of the calling thread in this case: it requires MPI_THREAD_MULTIPLE and
+/// the members are read on a geometry defined on its own (duplicated) communicator, so that
+/// messages of both threads cannot match each other.
+template<typename MODEL> class BUMPMemberReader {
+  typedef oops::Geometry<MODEL>  Geometry_;
+  typedef oops::Increment<MODEL> Increment_;
+
+ public:
+  BUMPMemberReader(const Geometry_ & geom,
+                   const oops::Variables & vars,
+                   const util::DateTime & time,
+                   const std::vector<eckit::LocalConfiguration> & membersConfig,
+                   const int & nPrefetch)
+    : membersConfig_(membersConfig), nSlots_(std::max(nPrefetch, 0) + 1), nRead_(0),
+      nTaken_(0), nReleased_(0), stop_(false), error_() {
+    // Allocate the increments on the calling thread
+    for (size_t jslot = 0; jslot < std::min(nSlots_, membersConfig_.size()); ++jslot) {
+      slots_.emplace_back(new Increment_(geom, vars, time));
+    }
+
+    // Start reading ahead
+    if (nSlots_ > 1 && membersConfig_.size() > 0) {
+      thread_ = std::thread(&BUMPMemberReader::readAhead, this);
+    }
+  }
+
+  ~BUMPMemberReader() {
+    if (thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+      }
+      cond_.notify_all();
+      thread_.join();
+    }
+  }
+
+  /// Next member, valid until the following call
+  Increment_ & next() {
+    ASSERT(nTaken_ < membersConfig_.size());
+    Increment_ & dx = *slots_[nTaken_ % nSlots_];
+    if (thread_.joinable()) {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      // Release the previous member slot
+      nReleased_ = nTaken_;
+      cond_.notify_all();
+
+      // Wait for this member
+      cond_.wait(lock, [this] {return nRead_ > nTaken_ || error_;});
+      if (error_) std::rethrow_exception(error_);
+    } else {
+      dx.read(membersConfig_[nTaken_]);
+    }
+    ++nTaken_;
+    return dx;
+  }
+
+ private:
+  void readAhead() {
+    try {
+      for (size_t ie = 0; ie < membersConfig_.size(); ++ie) {
+        {
+          // Wait for a free slot
+          std::unique_lock<std::mutex> lock(mutex_);
+          cond_.wait(lock, [this, ie] {return ie < nReleased_ + nSlots_ || stop_;});
+          if (stop_) return;
+        }
+        slots_[ie % nSlots_]->read(membersConfig_[ie]);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          nRead_ = ie + 1;
+        }
+        cond_.notify_all();
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+      }
+      cond_.notify_all();
+    }
+  }
+
+  const std::vector<eckit::LocalConfiguration> & membersConfig_;
+  const size_t nSlots_;
+  std::vector<std::unique_ptr<Increment_>> slots_;
+  size_t nRead_;
+  size_t nTaken_;
+  size_t nReleased_;
+  bool stop_;
+  std::exception_ptr error_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread thread_;
+};
+
 // -----------------------------------------------------------------------------
 
 template<typename MODEL> class BUMP {
@@ -499,7 +641,9 @@ template<typename MODEL> class BUMP {
        const State_ &,
        const State_ &,
        const EnsemblePtr_ ens1 = NULL,
-       const EnsemblePtr_ ens2 = NULL);
+       const EnsemblePtr_ ens2 = NULL,
+       const Geometry_ * geomIO1 = NULL,
+       const Geometry_ * geomIO2 = NULL);
 
   // Copy
   explicit BUMP(BUMP &);
@@ -527,6 +671,7 @@ template<typename MODEL> class BUMP {
   void getParameter(const std::string &, const int &, const int &, atlas::FieldSet &) const;
   void setNcmp(const int &, const int &, const int &) const;
   void setParameter(const std::string &, const int &, const atlas::FieldSet &) const;
+  void updateNicas() const;
   void partialDealloc() const;
 
  private:
@@ -546,7 +691,9 @@ BUMP<MODEL>::BUMP(const Geometry_ & geom1,
                   const State_ & xb,
                   const State_ & fg,
                   const EnsemblePtr_ ens1,
-                  const EnsemblePtr_ ens2)
+                  const EnsemblePtr_ ens2,
+                  const Geometry_ * geomIO1,
+                  const Geometry_ * geomIO2)
   : activeVars_(activeVars), params_(params), keyBUMP_(), activeVarsPerGrid_() {
   oops::Log::trace() << "BUMP<MODEL>::BUMP construction starting" << std::endl;
 
@@ -856,46 +1003,76 @@ BUMP<MODEL>::BUMP(const Geometry_ & geom1,
   const boost::optional<bool> &update_var = params_.update_var.value();
   const boost::optional<bool> &update_mom = params_.update_mom.value();
 
-  // Load ensemble members sequentially
+  // Number of members read ahead
+  int nPrefetch = 0;
+  const boost::optional<int> &ensemblePrefetch = params_.ensemblePrefetch.value();
+  if (ensemblePrefetch != boost::none) nPrefetch = *ensemblePrefetch;
+  if (nPrefetch > 0) {
+    // Background reads are collective, they need MPI_THREAD_MULTIPLE
+    int provided;
+    MPI_Query_thread(&provided);
+    if (provided != MPI_THREAD_MULTIPLE) {
+      ABORT("BUMP: ensemble prefetch requires MPI_THREAD_MULTIPLE (set ECKIT_MPI_INIT_THREAD)");
+    }
+
+    // Background reads need their own communicator
+    if (ensembleConfig1 != boost::none) {
+      if (geomIO1 == NULL || &geomIO1->getComm() == &geom1.getComm()) {
+        ABORT("BUMP: ensemble prefetch requires a geometry on a duplicated communicator");
+      }
+    }
+    if (ensembleConfig2 != boost::none) {
+      if (geomIO2 == NULL || &geomIO2->getComm() == &geom2.getComm()) {
+        ABORT("BUMP: ensemble prefetch requires a geometry on a duplicated communicator");
+      }
+    }
+    oops::Log::info() << "BUMP: " << nPrefetch << " ensemble member(s) read ahead" << std::endl;
+  }
+
+  // Load ensemble members, in order
   if (ensembleConfig1 != boost::none) {
+    BUMPMemberReader<MODEL> reader1(nPrefetch > 0 ? *geomIO1 : geom1, activeVars_, xb.validTime(),
+                                    membersConfig1, nPrefetch);
     for (int ie = 0; ie < ens1_ne; ++ie) {
       // Read member
       oops::Log::info() <<
       "-------------------------------------------------------------------" << std::endl;
       oops::Log::info() << "--- Load member " << ie+1 << " / " << ens1_ne << std::endl;
-      dx1.read(membersConfig1[ie]);
+      Increment_ & dx = reader1.next();
 
       if (update_vbal_cov != boost::none) {
         if (*update_vbal_cov) {
           // Update vertical covariance
-          this->updateVbalCov(dx1.fieldSet(), ie);
+          this->updateVbalCov(dx.fieldSet(), ie);
         }
       }
       if (update_var != boost::none) {
         if (*update_var) {
           // Update variance
-          this->updateVar(dx1.fieldSet(), ie);
+          this->updateVar(dx.fieldSet(), ie);
         }
       }
       if (update_mom != boost::none) {
         if (*update_mom) {
           // Update moments
-          this->updateMom(dx1.fieldSet(), ie, 1);
+          this->updateMom(dx.fieldSet(), ie, 1);
         }
       }
     }
   }
   if (ensembleConfig2 != boost::none) {
+    BUMPMemberReader<MODEL> reader2(nPrefetch > 0 ? *geomIO2 : geom2, activeVars_, xb.validTime(),
+                                    membersConfig2, nPrefetch);
     for (int ie = 0; ie < ens2_ne; ++ie) {
       // Read member
       oops::Log::info() <<
       "-------------------------------------------------------------------" << std::endl;
       oops::Log::info() << "--- Load member " << ie+1 << " / " << ens2_ne << std::endl;
-      dx2.read(membersConfig2[ie]);
+      Increment_ & dx = reader2.next();
       if (update_mom != boost::none) {
         if (*update_mom) {
           // Update moments
-          this->updateMom(dx2.fieldSet(), ie, 2);
+          this->updateMom(dx.fieldSet(), ie, 2);
         }
       }
     }
@@ -1234,6 +1411,15 @@ void BUMP<MODEL>::setParameter(const std::string & param, const int & icmp,
 
 // -----------------------------------------------------------------------------
 
+template<typename MODEL>
+void BUMP<MODEL>::updateNicas() const {
+  for (unsigned int jgrid = 0; jgrid < keyBUMP_.size(); ++jgrid) {
+    bump_update_nicas_f90(keyBUMP_[jgrid]);
+  }
+}
+
+// -----------------------------------------------------------------------------
+
 template<typename MODEL>
 void BUMP<MODEL>::partialDealloc() const {
   for (unsigned int jgrid = 0; jgrid < keyBUMP_.size(); ++jgrid) {
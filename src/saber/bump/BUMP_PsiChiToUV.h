@@ -62,6 +62,8 @@ class BUMP_PsiChiToUV : public SaberBlockBase<MODEL> {
   void multiplyAD(atlas::FieldSet &) const override;
   void inverseMultiplyAD(atlas::FieldSet &) const override;
 
+  bool hasInverse() const override {return false;}
+
  private:
   void print(std::ostream &) const override;
   std::unique_ptr<BUMP_> bump_;
@@ -5,14 +5,18 @@
  * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
  */
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/types.h>
 #include <unistd.h>
 
-uint32_t fletcher32(uint32_t *n, uint16_t const *var)
+static uint32_t fletcher32_words(size_t words, uint16_t const *var)
 {
   uint32_t sum1 = 0xffff, sum2 = 0xffff;
-  size_t tlen; uint32_t words = *n;
+  size_t tlen;
   while (words) {
     tlen = ((words >= 359) ? 359 : words);
     words -= tlen;
@@ -27,3 +31,79 @@ uint32_t fletcher32(uint32_t *n, uint16_t const *var)
   sum2 = (sum2 & 0xffff) + (sum2 >> 16);
   return (sum2 << 16) | sum1;
 }
+
+uint32_t fletcher32(uint32_t *n, uint16_t const *var)
+{
+  return fletcher32_words(*n, var);
+}
+
+/* NICAS cache: the file is created (and sized) once, then every task writes and maps its own
+   segments at known offsets. Functions return 0 on success, errno otherwise. */
+
+int nicas_cache_create(char const *filename, int64_t const *nbytes)
+{
+  int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return errno;
+  if (ftruncate(fd, (off_t)*nbytes) != 0) {
+    int err = errno;
+    close(fd);
+    return err;
+  }
+  if (close(fd) != 0) return errno;
+  return 0;
+}
+
+int nicas_cache_write(char const *filename, int64_t const *offset, int64_t const *nbytes,
+                      void const *data)
+{
+  int fd = open(filename, O_WRONLY);
+  if (fd < 0) return errno;
+  char const *buf = (char const *)data;
+  off_t pos = (off_t)*offset;
+  size_t left = (size_t)*nbytes;
+  while (left > 0) {
+    ssize_t done = pwrite(fd, buf, left, pos);
+    if (done < 0) {
+      if (errno == EINTR) continue;
+      int err = errno;
+      close(fd);
+      return err;
+    }
+    buf += done;
+    pos += done;
+    left -= (size_t)done;
+  }
+  if (close(fd) != 0) return errno;
+  return 0;
+}
+
+int nicas_cache_map(char const *filename, int64_t const *offset, int64_t const *nbytes,
+                    void **data)
+{
+  int64_t page = sysconf(_SC_PAGESIZE);
+  int64_t shift = *offset % page;
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) return errno;
+  char *base = mmap(NULL, (size_t)(*nbytes + shift), PROT_READ, MAP_PRIVATE, fd,
+                    (off_t)(*offset - shift));
+  int err = (base == MAP_FAILED) ? errno : 0;
+  close(fd);
+  if (err) return err;
+  madvise(base, (size_t)(*nbytes + shift), MADV_SEQUENTIAL);
+  *data = base + shift;
+  return 0;
+}
+
+int nicas_cache_unmap(void *data, int64_t const *offset, int64_t const *nbytes)
+{
+  int64_t page = sysconf(_SC_PAGESIZE);
+  int64_t shift = *offset % page;
+  char *base = data;
+  if (munmap(base - shift, (size_t)(*nbytes + shift)) != 0) return errno;
+  return 0;
+}
+
+uint32_t nicas_cache_checksum(int64_t const *nbytes, void const *data)
+{
+  return fletcher32_words((size_t)(*nbytes / 2), (uint16_t const *)data);
+}
@@ -56,6 +56,7 @@ extern "C" {
   void bump_set_ncmp_f90(const int &, const int &, const int &);
   void bump_set_parameter_f90(const int &, const int &, const char *,
                               const int &, const atlas::field::FieldSetImpl *);
+  void bump_update_nicas_f90(const int &);
   void bump_partial_dealloc_f90(const int &);
   void bump_dealloc_f90(const int &);
 }
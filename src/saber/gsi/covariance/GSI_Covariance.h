@@ -66,6 +66,8 @@ class Covariance : public SaberBlockBase<MODEL> {
   void multiplyAD(atlas::FieldSet &) const override;
   void inverseMultiplyAD(atlas::FieldSet &) const override;
 
+  bool hasInverse() const override {return false;}
+
  private:
   void print(std::ostream &) const override;
   // Fortran LinkedList key
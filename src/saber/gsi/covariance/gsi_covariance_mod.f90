@@ -56,6 +56,13 @@ type :: gsi_covariance
   logical :: cv   ! cv=.true.; sv=.false.
   integer :: mp_comm_world
   integer :: rank
+  ! Workspace, allocated at create and reused by multiply and multiply_ad
+  logical :: wsalloc = .false.
+  type(control_vector) :: gsicv
+  type(gsi_bundle),allocatable :: gsisv(:)
+  character(len=20),allocatable :: gvars2d(:),gvars3d(:)
+  character(len=30),allocatable :: tbdinit(:),tbdvars(:),needvrs(:)
+  real(kind=kind_real),allocatable :: t_pt(:,:,:)
   contains
     procedure, public :: create
     procedure, public :: delete
@@ -191,6 +198,10 @@ if (.not. self%grid%noGSI) then
      
   endif
 
+! Allocate workspace
+! ------------------
+  call workspace_create_(self)
+
 endif
 
 contains
@@ -243,6 +254,7 @@ class(gsi_covariance) :: self
 
 if (.not. self%grid%noGSI) then
 !! call gsibec_final(.false.)
+   call workspace_delete_(self)
 endif
 
 ! Delete the grid
@@ -330,131 +342,181 @@ subroutine multiply(self, fields)
 class(gsi_covariance), intent(inout) :: self
 type(atlas_fieldset),  intent(inout) :: fields
 
+call apply_(self, fields, .false.)
+
+end subroutine multiply
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine multiply_ad(self, fields)
+
+! Arguments
+class(gsi_covariance), intent(inout) :: self
+type(atlas_fieldset),  intent(inout) :: fields
+
+! B is symmetric but the Atlas/GSI halo transfers are not, so the adjoint
+! applies the adjoint transfers around the same B-error operator
+call apply_(self, fields, .true.)
+
+end subroutine multiply_ad
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine workspace_create_(self)
+
+! Arguments
+class(gsi_covariance), intent(inout) :: self
+
 ! Locals
-character(len=*), parameter :: myname_=myname//'*multiply'
-type(atlas_field) :: afield
+integer :: iv,itbd
+
+if (self%wsalloc) return
+
+! Allocate control vector as defined in GSI
+! -----------------------------------------
+if (self%cv) then
+   allocate(self%gvars2d(size(cvars2d)),self%gvars3d(size(cvars3d)))
+   self%gvars2d=cvars2d; self%gvars3d=cvars3d
+   call allocate_cv(self%gsicv)
+else
+   allocate(self%gvars2d(size(svars2d)),self%gvars3d(size(svars3d)))
+   self%gvars2d=svars2d; self%gvars3d=svars3d
+   allocate(self%gsisv(1))
+   call allocate_state(self%gsisv(1))
+endif
+allocate(self%tbdinit(size(self%gvars2d)+size(self%gvars3d)))
+allocate(self%tbdvars(size(self%gvars2d)+size(self%gvars3d)))
+allocate(self%needvrs(size(self%gvars2d)+size(self%gvars3d)))
+self%tbdinit="null"
+itbd=0
+do iv = 1,size(self%gvars2d)
+   itbd=itbd+1
+   self%tbdinit(itbd) = "unfilled-"//trim(self%gvars2d(iv))
+enddo
+do iv = 1,size(self%gvars3d)
+   itbd=itbd+1
+   self%tbdinit(itbd) = "unfilled-"//trim(self%gvars3d(iv))
+enddo
+
+self%wsalloc = .true.
+
+end subroutine workspace_create_
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine workspace_delete_(self)
+
+! Arguments
+class(gsi_covariance), intent(inout) :: self
+
+if (.not. self%wsalloc) return
+
+if (self%cv) then
+   call deallocate_cv(self%gsicv)
+else
+   call deallocate_state(self%gsisv(1))
+   deallocate(self%gsisv)
+endif
+deallocate(self%needvrs)
+deallocate(self%tbdvars)
+deallocate(self%tbdinit)
+deallocate(self%gvars2d,self%gvars3d)
+if (allocated(self%t_pt)) deallocate(self%t_pt)
+
+self%wsalloc = .false.
+
+end subroutine workspace_delete_
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine apply_(self, fields, adjoint)
+
+! Arguments
+class(gsi_covariance), intent(inout) :: self
+type(atlas_fieldset),  intent(inout) :: fields
+logical,               intent(in)    :: adjoint
+
+! Locals
+character(len=*), parameter :: myname_=myname//'*apply_'
 real(kind=kind_real), pointer :: rank2(:,:)     =>NULL()
 real(kind=kind_real), pointer :: gsivar3d(:,:,:)=>NULL()
 real(kind=kind_real), pointer :: gsivar2d(:,:)  =>NULL()
-real(kind=kind_real), allocatable :: aux(:,:)
-real(kind=kind_real), allocatable :: aux1(:)
-
-type(control_vector) :: gsicv
-type(gsi_bundle),allocatable :: gsisv(:)
-integer :: isc,iec,jsc,jec,npz
+integer :: npz
 integer :: iv,k,ier,itbd
-integer,parameter :: hw=1
-logical nosgi
-integer, parameter :: rseed = 3
 
-character(len=20),allocatable :: gvars2d(:),gvars3d(:)
-character(len=30),allocatable :: tbdvars(:),needvrs(:)
-
-! afield = fields%field('surface_pressure')
-! call afield%data(rank2)
-! rank2 = 0.0_kind_real
-! rank2(1,int(size(rank1)/2)) = 1.0_kind_real
-! return
 if (self%grid%noGSI) return
 
 !   gsi-surface: k=1
 !   quench-surface: k=1
 !   fv3-surface: k=km
-isc=self%grid%isc
-iec=self%grid%iec
-jsc=self%grid%jsc
-jec=self%grid%jec
 npz=self%grid%npz
 
-! Allocate control vector as defined in GSI
-! -----------------------------------------
+! Reset workspace
+! ---------------
 if (self%cv) then
-   allocate(gvars2d(size(cvars2d)),gvars3d(size(cvars3d)))
-   gvars2d=cvars2d; gvars3d=cvars3d
-   call allocate_cv(gsicv)
+   self%gsicv=0.0_kind_real
 else
-   allocate(gvars2d(size(svars2d)),gvars3d(size(svars3d)))
-   gvars2d=svars2d; gvars3d=svars3d
-   allocate(gsisv(1))
-   call allocate_state(gsisv(1))
+   self%gsisv(1)%values=0.0_kind_real
 endif
-allocate(tbdvars(size(gvars2d)+size(gvars3d)))
-allocate(needvrs(size(gvars2d)+size(gvars3d)))
-tbdvars="null"
-itbd=0
-do iv = 1,size(gvars2d)
-   itbd=itbd+1
-   tbdvars(itbd) = "unfilled-"//trim(gvars2d(iv))
-enddo
-do iv = 1,size(gvars3d)
-   itbd=itbd+1
-   tbdvars(itbd) = "unfilled-"//trim(gvars3d(iv))
-enddo
+self%tbdvars=self%tbdinit
 
 ! Convert Atlas fieldsets to GSI bundle fields
 ! --------------------------------------------
 itbd=0
-do iv=1,size(gvars2d)
+do iv=1,size(self%gvars2d)
    itbd=itbd+1
    if (self%cv) then
-      call gsi_bundlegetpointer (gsicv%step(1),gvars2d(iv),gsivar2d,ier)
+      call gsi_bundlegetpointer (self%gsicv%step(1),self%gvars2d(iv),gsivar2d,ier)
    else
-      call gsi_bundlegetpointer (     gsisv(1),gvars2d(iv),gsivar2d,ier)
+      call gsi_bundlegetpointer (     self%gsisv(1),self%gvars2d(iv),gsivar2d,ier)
    endif
    if (ier/=0) cycle
-   call get_rank2_(rank2,fields,trim(gvars2d(iv)),ier)
+   call get_rank2_(rank2,fields,trim(self%gvars2d(iv)),ier)
    if (ier==0) then
-      tbdvars(itbd) = 'filled-'//trim(gvars2d(iv))
+      self%tbdvars(itbd) = 'filled-'//trim(self%gvars2d(iv))
    else
-      tbdvars(itbd) = trim(gvars2d(iv))
+      self%tbdvars(itbd) = trim(self%gvars2d(iv))
       cycle
    endif
-   allocate(aux(size(gsivar2d,1),size(gsivar2d,2)))
-   call addhalo_(rank2(1,:),aux)
-   gsivar2d=aux
-   deallocate(aux)
+   call tohalo_(adjoint,rank2(1,:),gsivar2d)
 enddo
-do iv=1,size(gvars3d)
+do iv=1,size(self%gvars3d)
    itbd=itbd+1
    if (self%cv) then
-      call gsi_bundlegetpointer (gsicv%step(1),gvars3d(iv),gsivar3d,ier)
+      call gsi_bundlegetpointer (self%gsicv%step(1),self%gvars3d(iv),gsivar3d,ier)
    else
-      call gsi_bundlegetpointer (     gsisv(1),gvars3d(iv),gsivar3d,ier)
+      call gsi_bundlegetpointer (     self%gsisv(1),self%gvars3d(iv),gsivar3d,ier)
    endif
    if (ier/=0) cycle
-   call get_rank2_(rank2,fields,trim(gvars3d(iv)),ier)
+   call get_rank2_(rank2,fields,trim(self%gvars3d(iv)),ier)
    if (ier==0) then
-      tbdvars(itbd) = 'filled-'//trim(gvars3d(iv))
+      self%tbdvars(itbd) = 'filled-'//trim(self%gvars3d(iv))
    else
-      tbdvars(itbd) = trim(gvars3d(iv))
+      self%tbdvars(itbd) = trim(self%gvars3d(iv))
       cycle
    endif
-   allocate(aux(size(gsivar3d,1),size(gsivar3d,2)))
    if (self%grid%vflip) then
       do k=1,npz
-         call addhalo_(rank2(k,:),aux)
-         gsivar3d(:,:,npz-k+1)=aux
+         call tohalo_(adjoint,rank2(k,:),gsivar3d(:,:,npz-k+1))
       enddo
    else
       do k=1,npz
-         call addhalo_(rank2(k,:),aux)
-         gsivar3d(:,:,k)=aux
+         call tohalo_(adjoint,rank2(k,:),gsivar3d(:,:,k))
       enddo
    endif
-   deallocate(aux)
 enddo
-needvrs=tbdvars
+self%needvrs=self%tbdvars
 
 ! fill in missing fields
 if (self%cv) then
-  call cvfix_(gsicv,fields,self%grid%vflip,needvrs,'adm')
+  call cvfix_(self%gsicv,fields,self%grid%vflip,self%needvrs,'adm',adjoint,self%t_pt)
 else
-  call svfix_(gsisv(1),fields,self%grid%vflip,needvrs,'adm')
+  call svfix_(self%gsisv(1),fields,self%grid%vflip,self%needvrs,'adm',adjoint,self%t_pt)
 endif
 ! check that all variables are consistently available
-if (any(needvrs(:)(1:6)/='filled')) then
-  do iv=1,size(needvrs)
-     print *, myname_, '*adm:: ', trim(needvrs(iv))  ! need single PE write/out
+if (any(self%needvrs(:)(1:6)/='filled')) then
+  do iv=1,size(self%needvrs)
+     print *, myname_, '*adm:: ', trim(self%needvrs(iv))  ! need single PE write/out
   enddo
   call abor1_ftn(myname_//": missing fields in cv(adm) ")
 endif
@@ -462,103 +524,60 @@ endif
 ! Apply GSI B-error operator
 ! --------------------------
 if (self%cv) then
-   call gsibec_cv_space(gsicv,internalcv=.false.,bypassbe=self%bypassGSIbe)
+   call gsibec_cv_space(self%gsicv,internalcv=.false.,bypassbe=self%bypassGSIbe)
 else
-   call gsibec_sv_space(gsisv,internalsv=.false.,bypassbe=self%bypassGSIbe)
+   call gsibec_sv_space(self%gsisv,internalsv=.false.,bypassbe=self%bypassGSIbe)
 endif
 
 ! Convert back to Atlas Fields
 ! ----------------------------
-do iv=1,size(gvars2d)
+do iv=1,size(self%gvars2d)
    if (self%cv) then
-      call gsi_bundlegetpointer (gsicv%step(1),gvars2d(iv),gsivar2d,ier)
+      call gsi_bundlegetpointer (self%gsicv%step(1),self%gvars2d(iv),gsivar2d,ier)
    else
-      call gsi_bundlegetpointer (gsisv(1),gvars2d(iv),gsivar2d,ier)
+      call gsi_bundlegetpointer (self%gsisv(1),self%gvars2d(iv),gsivar2d,ier)
    endif
    if (ier/=0) cycle
-   call get_rank2_(rank2,fields,trim(gvars2d(iv)),ier)
+   call get_rank2_(rank2,fields,trim(self%gvars2d(iv)),ier)
    if (ier/=0) cycle
-   allocate(aux1(size(rank2,2)))
-   call remhalo_(gsivar2d,aux1)
-   rank2(1,:)=aux1
-   deallocate(aux1)
+   call fromhalo_(adjoint,gsivar2d,rank2(1,:))
 enddo
-do iv=1,size(gvars3d)
+do iv=1,size(self%gvars3d)
    if (self%cv) then
-      call gsi_bundlegetpointer (gsicv%step(1),gvars3d(iv),gsivar3d,ier)
+      call gsi_bundlegetpointer (self%gsicv%step(1),self%gvars3d(iv),gsivar3d,ier)
    else
-      call gsi_bundlegetpointer (gsisv(1),gvars3d(iv),gsivar3d,ier)
+      call gsi_bundlegetpointer (self%gsisv(1),self%gvars3d(iv),gsivar3d,ier)
    endif
    if (ier/=0) cycle
-   call get_rank2_(rank2,fields,trim(gvars3d(iv)),ier)
+   call get_rank2_(rank2,fields,trim(self%gvars3d(iv)),ier)
    if (ier/=0) cycle
-   allocate(aux1(size(rank2,2)))
    if (self%grid%vflip) then
       do k=1,npz
-         call remhalo_(gsivar3d(:,:,k),aux1)
-         rank2(npz-k+1,:)=aux1
+         call fromhalo_(adjoint,gsivar3d(:,:,k),rank2(npz-k+1,:))
       enddo
    else
       do k=1,npz
-         call remhalo_(gsivar3d(:,:,k),aux1)
-         rank2(k,:)=aux1
+         call fromhalo_(adjoint,gsivar3d(:,:,k),rank2(k,:))
       enddo
    endif
-   deallocate(aux1)
 enddo
 
 ! Fill in missing fields
-needvrs=tbdvars
+self%needvrs=self%tbdvars
 if (self%cv) then
-  call cvfix_(gsicv,fields,self%grid%vflip,needvrs,'tlm')
+  call cvfix_(self%gsicv,fields,self%grid%vflip,self%needvrs,'tlm',adjoint,self%t_pt)
 else
-  call svfix_(gsisv(1),fields,self%grid%vflip,needvrs,'tlm')
+  call svfix_(self%gsisv(1),fields,self%grid%vflip,self%needvrs,'tlm',adjoint,self%t_pt)
 endif
 ! Check that all variables are consistently available
-if (any(needvrs(:)(1:6)/='filled')) then
-  do iv=1,size(needvrs)
-     print *, myname_, '*tlm:: ', trim(needvrs(iv))  ! need single PE write/out
+if (any(self%needvrs(:)(1:6)/='filled')) then
+  do iv=1,size(self%needvrs)
+     print *, myname_, '*tlm:: ', trim(self%needvrs(iv))  ! need single PE write/out
   enddo
   call abor1_ftn(myname_//": missing fields in cv(tlm) ")
 endif
 
-
-! Release pointer
-! ---------------
-if (self%cv) then
-   call deallocate_cv(gsicv)
-else
-   call deallocate_state(gsisv(1))
-   deallocate(gsisv)
-endif
-deallocate(needvrs)
-deallocate(tbdvars)
-deallocate(gvars2d,gvars3d)
-call afield%final()
-
-!contains
-
-
-end subroutine multiply
-
-! --------------------------------------------------------------------------------------------------
-
-subroutine multiply_ad(self, fields)
-
-! Arguments
-class(gsi_covariance), intent(inout) :: self
-type(atlas_fieldset),  intent(inout) :: fields
-
-! This routine only needed when B = G^T G (sqrt-factored)
-
-! To do list for this method
-! 1. Convert fields (Atlas fieldsets) to GSI bundle
-! 2. Call GSI covariance operator adjoint (sqrt version)
-!        afield = fields%field('stream_function')
-!        call afield%data(var3d)
-!        var3d=0.0_kind_real
-
-end subroutine multiply_ad
+end subroutine apply_
 
 ! --------------------------------------------------------------------------------------------------
 
@@ -713,7 +732,71 @@ end subroutine multiply_ad
    enddo
    end subroutine remhalo_
 
-   subroutine cvfix_(gsicv,jedicv,vflip,need,which)
+   subroutine remhalo_ad_(rank,var)
+   ! Adjoint of remhalo_
+   real(kind=kind_real),intent(in) :: rank(:)
+   real(kind=kind_real),intent(inout):: var(:,:)
+   integer ii,jj,jnode
+   integer mylat2,mylon2
+   mylat2 = size(var,1)
+   mylon2 = size(var,2)
+   var = 0.0_kind_real
+   jnode=1
+   do jj=2,mylat2-1
+      do ii=2,mylon2-1
+         var(jj,ii) = rank(jnode)
+         jnode = jnode + 1
+      enddo
+   enddo
+   end subroutine remhalo_ad_
+
+   subroutine addhalo_ad_(var,rank)
+   ! Adjoint of addhalo_, including the halo filled with the mean
+   real(kind=kind_real),intent(in) :: var(:,:)
+   real(kind=kind_real),intent(out):: rank(:)
+   integer ii,jj,jnode
+   integer mylat2,mylon2,ndim
+   real(kind=kind_real) :: halosum
+   mylat2 = size(var,1)
+   mylon2 = size(var,2)
+   ndim = (mylat2-2)*(mylon2-2)
+   rank = 0.0_kind_real
+   jnode=1
+   do jj=2,mylat2-1
+      do ii=2,mylon2-1
+         rank(jnode) = var(jj,ii)
+         jnode = jnode + 1
+      enddo
+   enddo
+   halosum = sum(var)-sum(var(2:mylat2-1,2:mylon2-1))
+   rank(1:ndim) = rank(1:ndim) + halosum/ndim
+   end subroutine addhalo_ad_
+
+   subroutine tohalo_(adjoint,rank,var)
+   ! JEDI to GSI transfer (or adjoint of the GSI to JEDI transfer)
+   logical,intent(in) :: adjoint
+   real(kind=kind_real),intent(in) :: rank(:)
+   real(kind=kind_real),intent(inout):: var(:,:)
+   if (adjoint) then
+      call remhalo_ad_(rank,var)
+   else
+      call addhalo_(rank,var)
+   endif
+   end subroutine tohalo_
+
+   subroutine fromhalo_(adjoint,var,rank)
+   ! GSI to JEDI transfer (or adjoint of the JEDI to GSI transfer)
+   logical,intent(in) :: adjoint
+   real(kind=kind_real),intent(in) :: var(:,:)
+   real(kind=kind_real),intent(inout):: rank(:)
+   if (adjoint) then
+      call addhalo_ad_(var,rank)
+   else
+      call remhalo_(var,rank)
+   endif
+   end subroutine fromhalo_
+
+   subroutine cvfix_(gsicv,jedicv,vflip,need,which,adjoint,t_pt)
  
    use control_vectors, only: control_vector
    use gsi_bundlemod, only: gsi_bundlegetpointer
@@ -729,14 +812,14 @@ end subroutine multiply_ad
    logical,intent(in) :: vflip
    character(len=*),intent(inout) :: need(:)
    character(len=*),intent(in) :: which
+   logical,intent(in) :: adjoint
+   real(kind=kind_real),allocatable,intent(inout) :: t_pt(:,:,:)
 ! 
-   real(kind=kind_real), allocatable :: t_pt(:,:,:)
    real(kind=kind_real), pointer ::    tv(:,:,:)=>NULL()
    real(kind=kind_real), pointer :: tv_pt(:,:,:)=>NULL()
    real(kind=kind_real), pointer ::     q(:,:,:)=>NULL()
    real(kind=kind_real), pointer ::  q_pt(:,:,:)=>NULL()
    real(kind=kind_real), pointer ::   rank2(:,:)=>NULL()
-   real(kind=kind_real), allocatable :: aux1(:)
    integer k,npz,ier
 !
    if(size(need)<1) return
@@ -750,33 +833,29 @@ end subroutine multiply_ad
       ! from JEDI cv ...
       call get_rank2_(rank2,jedicv,'t',ier)
       npz=size(q,3)
-      allocate(t_pt(size(q,1),size(q,2),size(q,3)))
+      if (.not.allocated(t_pt)) allocate(t_pt(size(q,1),size(q,2),size(q,3)))
       if (vflip) then
          do k=1,npz
-            call addhalo_(rank2(k,:),t_pt(:,:,npz-k+1))
+            call tohalo_(adjoint,rank2(k,:),t_pt(:,:,npz-k+1))
          enddo
       else
          do k=1,npz
-            call addhalo_(rank2(k,:),t_pt(:,:,k))
+            call tohalo_(adjoint,rank2(k,:),t_pt(:,:,k))
          enddo
       endif
       ! retrieve missing field
       if(which=='tlm') then
         call gsi_tv_to_t_tl(tv,tv_pt,q,q_pt,t_pt)
         ! pass it back to JEDI ...
-        allocate(aux1(size(rank2,2)))
         if (vflip) then
            do k=1,npz
-              call remhalo_(t_pt(:,:,k),aux1)
-              rank2(npz-k+1,:)=aux1
+              call fromhalo_(adjoint,t_pt(:,:,k),rank2(npz-k+1,:))
            enddo
         else
            do k=1,npz
-              call remhalo_(t_pt(:,:,k),aux1)
-              rank2(k,:)=aux1
+              call fromhalo_(adjoint,t_pt(:,:,k),rank2(k,:))
            enddo
         endif
-        deallocate(aux1)
         where(need=='tv')
            need='filled-'//need
         endwhere
@@ -787,11 +866,10 @@ end subroutine multiply_ad
            need='filled-'//need
         endwhere
       endif
-      deallocate(t_pt)
    endif
    end subroutine cvfix_
 
-   subroutine svfix_(gsisv,jedicv,vflip,need,which)
+   subroutine svfix_(gsisv,jedicv,vflip,need,which,adjoint,t_pt)
  
    use gsi_bundlemod, only: gsi_bundle
    use gsi_bundlemod, only: gsi_bundlegetpointer
@@ -807,14 +885,14 @@ end subroutine multiply_ad
    logical,intent(in) :: vflip
    character(len=*),intent(inout) :: need(:)
    character(len=*),intent(in) :: which
+   logical,intent(in) :: adjoint
+   real(kind=kind_real),allocatable,intent(inout) :: t_pt(:,:,:)
 ! 
-   real(kind=kind_real), allocatable :: t_pt(:,:,:)
    real(kind=kind_real), pointer ::       tv(:,:,:)=>NULL()
    real(kind=kind_real), pointer ::    tv_pt(:,:,:)=>NULL()
    real(kind=kind_real), pointer ::        q(:,:,:)=>NULL()
    real(kind=kind_real), pointer ::     q_pt(:,:,:)=>NULL()
    real(kind=kind_real), pointer ::      rank2(:,:)=>NULL()
-   real(kind=kind_real), allocatable :: aux1(:)
    integer k,npz,ier
 !
    if(size(need)<1) return
@@ -835,14 +913,14 @@ end subroutine multiply_ad
       ! from JEDI cv ...
       call get_rank2_(rank2,jedicv,'t',ier)
       npz=size(q,3)
-      allocate(t_pt(size(q,1),size(q,2),size(q,3)))
+      if (.not.allocated(t_pt)) allocate(t_pt(size(q,1),size(q,2),size(q,3)))
       if (vflip) then
          do k=1,npz
-            call addhalo_(rank2(k,:),t_pt(:,:,npz-k+1))
+            call tohalo_(adjoint,rank2(k,:),t_pt(:,:,npz-k+1))
          enddo
       else
          do k=1,npz
-            call addhalo_(rank2(k,:),t_pt(:,:,k))
+            call tohalo_(adjoint,rank2(k,:),t_pt(:,:,k))
          enddo
       endif
       ! retrieve missing field
@@ -852,19 +930,15 @@ end subroutine multiply_ad
            need='filled-'//need
         endwhere
         ! pass it back to JEDI ...
-        allocate(aux1(size(rank2,2)))
         if (vflip) then
            do k=1,npz
-              call remhalo_(t_pt(:,:,k),aux1)
-              rank2(npz-k+1,:)=aux1
+              call fromhalo_(adjoint,t_pt(:,:,k),rank2(npz-k+1,:))
            enddo
         else
            do k=1,npz
-              call remhalo_(t_pt(:,:,k),aux1)
-              rank2(k,:)=aux1
+              call fromhalo_(adjoint,t_pt(:,:,k),rank2(k,:))
            enddo
         endif
-        deallocate(aux1)
       endif
       if(which=='adm') then
         call gsi_tv_to_t_ad(tv,tv_pt,q,q_pt,t_pt)
@@ -872,7 +946,6 @@ end subroutine multiply_ad
            need='filled-'//need
         endwhere
       endif
-      deallocate(t_pt)
    endif
    end subroutine svfix_
 
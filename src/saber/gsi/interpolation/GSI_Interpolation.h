@@ -59,6 +59,8 @@ class Interpolation : public SaberBlockBase<MODEL> {
   void multiplyAD(atlas::FieldSet &) const override;
   void inverseMultiplyAD(atlas::FieldSet &) const override;
 
+  bool hasInverse() const override {return false;}
+
  private:
   void print(std::ostream &) const override;
   // GSI Interpolation implementation
@@ -103,7 +105,7 @@ template<typename MODEL>
 void Interpolation<MODEL>::multiply(atlas::FieldSet & fset) const {
   oops::Log::trace() << classname() << "::multiply starting" << std::endl;
   util::Timer timer(classname(), "multiply");
-  interpolationImpl_.multiply(fset);
+  interpolationImpl_.multiply(fset, this->fieldSetPool());
   oops::Log::trace() << classname() << "::multiply done" << std::endl;
 }
 
@@ -120,7 +122,7 @@ template<typename MODEL>
 void Interpolation<MODEL>::multiplyAD(atlas::FieldSet & fset) const {
   oops::Log::trace() << classname() << "::multiplyAD starting" << std::endl;
   util::Timer timer(classname(), "multiplyAD");
-  interpolationImpl_.multiplyAD(fset);
+  interpolationImpl_.multiplyAD(fset, this->fieldSetPool());
   oops::Log::trace() << classname() << "::multiplyAD done" << std::endl;
 }
 
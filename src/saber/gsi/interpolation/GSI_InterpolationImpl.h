@@ -25,6 +25,7 @@
 
 #include "saber/gsi/grid/GSI_Grid.h"
 #include "saber/gsi/interpolation/unstructured_interp/UnstructuredInterpolation.h"
+#include "saber/oops/FieldSetPool.h"
 
 using atlas::option::levels;
 using atlas::option::name;
@@ -59,8 +60,8 @@ class InterpolationImpl {
   InterpolationImpl(const Comm_ &, const PointCloud_ &, const Parameters_ &,
                     const std::vector<std::string>);
   ~InterpolationImpl();
-  void multiply(atlas::FieldSet &) const;
-  void multiplyAD(atlas::FieldSet &) const;
+  void multiply(atlas::FieldSet &, FieldSetPool * pool = nullptr) const;
+  void multiplyAD(atlas::FieldSet &, FieldSetPool * pool = nullptr) const;
 
  private:
   void print(std::ostream &) const;
@@ -115,7 +116,7 @@ InterpolationImpl::~InterpolationImpl() {
 
 // -------------------------------------------------------------------------------------------------
 
-void InterpolationImpl::multiply(atlas::FieldSet & fset) const {
+void InterpolationImpl::multiply(atlas::FieldSet & fset, FieldSetPool * pool) const {
   oops::Log::trace() << classname() << "::multiply starting" << std::endl;
   util::Timer timer(classname(), "multiply");
 
@@ -133,10 +134,15 @@ void InterpolationImpl::multiply(atlas::FieldSet & fset) const {
         ABORT("Field " + fieldNameStr + " not found in the " + classname() + " variables.");
       }
 
-      // Create the model field and add to Fieldset
-      modFields.add(modGridFuncSpace_.createField<double>(fieldName | levels(sabField.levels())));
+      // Create the model field and add to Fieldset (unless pooled)
+      if (!pool) {
+        modFields.add(modGridFuncSpace_.createField<double>(fieldName | levels(sabField.levels())));
+      }
   }
 
+  // Pooled model fields
+  if (pool) modFields = pool->get("multiply", modGridFuncSpace_, fset);
+
   // Do the interpolation from GSI grid to model grid
   interpolator_->apply(fset, modFields);
 
@@ -148,7 +154,7 @@ void InterpolationImpl::multiply(atlas::FieldSet & fset) const {
 
 // -------------------------------------------------------------------------------------------------
 
-void InterpolationImpl::multiplyAD(atlas::FieldSet & fset) const {
+void InterpolationImpl::multiplyAD(atlas::FieldSet & fset, FieldSetPool * pool) const {
   oops::Log::trace() << classname() << "::multiplyAD starting" << std::endl;
   util::Timer timer(classname(), "multiplyAD");
 
@@ -166,10 +172,15 @@ void InterpolationImpl::multiplyAD(atlas::FieldSet & fset) const {
         ABORT("Field " + fieldNameStr + " not found in the " + classname() + " variables.");
       }
 
-      // Create the field and add to Fieldset
-      gsiFields.add(gsiGridFuncSpace_.createField<double>(fieldName | levels(sabField.levels())));
+      // Create the field and add to Fieldset (unless pooled)
+      if (!pool) {
+        gsiFields.add(gsiGridFuncSpace_.createField<double>(fieldName | levels(sabField.levels())));
+      }
   }
 
+  // Pooled GSI fields
+  if (pool) gsiFields = pool->get("multiplyAD", gsiGridFuncSpace_, fset);
+
   // Do the adjoint of interpolation from GSI grid to model grid
   interpolator_->apply_ad(fset, gsiFields);
 
@@ -67,8 +67,9 @@ void UnstructuredInterpolation::apply(const atlas::FieldSet & infields,
                               atlas::option::levels(infields[ifield].levels()));
       outfields.add(outfield);
     }
-    this->apply(infields[fname], outfields[fname]);
   }
+  // Single donor exchange for all the fields and levels
+  saber_unstrc_apply_fieldset_f90(keyUnstructuredInterpolator_, infields.get(), outfields.get());
 }
 
 // -----------------------------------------------------------------------------
@@ -82,8 +83,10 @@ void UnstructuredInterpolation::apply_ad(const atlas::FieldSet & fields_grid2,
                             atlas::option::levels(fields_grid2[ifield].levels()));
       fields_grid1.add(field1);
     }
-    this->apply_ad(fields_grid2[fname], fields_grid1[fname]);
   }
+  // Single donor exchange for all the fields and levels
+  saber_unstrc_apply_ad_fieldset_f90(keyUnstructuredInterpolator_, fields_grid2.get(),
+                                     fields_grid1.get());
 }
 
 // -----------------------------------------------------------------------------
@@ -30,6 +30,10 @@ extern "C" {
                        atlas::field::FieldImpl *);
   void saber_unstrc_apply_ad_f90(const int &, const atlas::field::FieldImpl *,
                        atlas::field::FieldImpl *);
+  void saber_unstrc_apply_fieldset_f90(const int &, const atlas::field::FieldSetImpl *,
+                       atlas::field::FieldSetImpl *);
+  void saber_unstrc_apply_ad_fieldset_f90(const int &, const atlas::field::FieldSetImpl *,
+                       atlas::field::FieldSetImpl *);
 }
 }  // namespace gsi
 }  // namespace saber
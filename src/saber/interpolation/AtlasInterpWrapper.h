@@ -28,6 +28,8 @@
 #include "atlas/util/PolygonLocator.h"
 #include "atlas/util/PolygonXY.h"
 
+#include "eckit/mpi/Comm.h"
+
 #include "oops/util/abor1_cpp.h"
 #include "oops/util/Logger.h"
 #include "oops/util/ObjectCounter.h"
@@ -62,8 +64,25 @@ class AtlasInterpWrapper {
   void executeAdjoint(atlas::FieldSet &, const atlas::FieldSet &) const;
 
  private:
+  void exchange(const std::vector<double> &, const std::vector<int> &, const std::vector<int> &,
+                std::vector<double> &, const std::vector<int> &, const std::vector<int> &,
+                const atlas::idx_t) const;
+
+  // MPI tag of the PointCloud point-to-point exchanges
+  static constexpr int exchangeTag_ = 7419;
+
   atlas::FunctionSpace localDstFunctionSpace_;
-  std::vector<size_t> localTask_;
+  // PointCloud destination: local destination points, grouped by owner task
+  std::vector<size_t> dstOrder_;
+  // PointCloud destination: number of local destination points owned by each task
+  std::vector<int> dstCounts_;
+  std::vector<int> dstDispls_;
+  // PointCloud destination: number of interpolation points requested by each task
+  std::vector<int> localCounts_;
+  std::vector<int> localDispls_;
+  size_t localSize_;
+  // PointCloud destination: index of each requested point in the local (unique) points
+  std::vector<size_t> localIndex_;
   atlas::FunctionSpace targetFunctionSpace_;
   atlas::Interpolation interp_;
   atlas::Redistribution redistr_;
@@ -179,26 +198,75 @@ AtlasInterpWrapper::AtlasInterpWrapper(const atlas::grid::Partitioner & srcParti
                                        const atlas::FunctionSpace & srcFunctionSpace,
                                        const atlas::Grid & dstGrid,
                                        const atlas::FunctionSpace & dstFunctionSpace) :
-  localDstFunctionSpace_(), targetFunctionSpace_(), interp_(), redistr_() {
+  localDstFunctionSpace_(), localSize_(0), targetFunctionSpace_(), interp_(), redistr_() {
   oops::Log::trace() << "AtlasInterpWrapper::AtlasInterpWrapper starting" << std::endl;
 
   if (dstFunctionSpace.type() == "PointCloud") {
     // PointCloud destination function space
     atlas::functionspace::PointCloud fs(dstFunctionSpace);
+    const eckit::mpi::Comm & comm = eckit::mpi::comm();
+    const size_t nproc = comm.size();
 
-    // Splitting points between distribution polygons
+    // Find the source partition owning each destination point
     const atlas::util::ListPolygonXY polygons(srcFunctionSpace.polygons());
     const atlas::util::PolygonLocator find_partition(polygons);
-    std::vector<atlas::PointXY> points;
+    std::vector<atlas::PointXY> dstPoints;
+    std::vector<size_t> dstTask;
     auto lonlatView = atlas::array::make_view<double, 2>(fs.lonlat());
     for (atlas::idx_t i = 0; i < fs.size(); ++i) {
       atlas::PointLonLat pointLonLat(lonlatView(i, 0), lonlatView(i, 1));
       pointLonLat.normalise();
       const atlas::PointXY point(pointLonLat);
-      localTask_.push_back(find_partition(point));
-      if (eckit::mpi::comm().rank() == localTask_[i]) {
-        points.push_back(point);
+      dstPoints.push_back(point);
+      dstTask.push_back(find_partition(point));
+    }
+
+    // Group local destination points by owner task
+    dstCounts_.assign(nproc, 0);
+    for (const size_t task : dstTask) {
+      dstCounts_[task] += 1;
+    }
+    dstDispls_.assign(nproc, 0);
+    for (size_t jproc = 1; jproc < nproc; ++jproc) {
+      dstDispls_[jproc] = dstDispls_[jproc-1] + dstCounts_[jproc-1];
+    }
+    dstOrder_.resize(dstTask.size());
+    std::vector<int> next(dstDispls_);
+    for (size_t i = 0; i < dstTask.size(); ++i) {
+      dstOrder_[static_cast<size_t>(next[dstTask[i]])] = i;
+      next[dstTask[i]] += 1;
+    }
+
+    // Number of points requested by each task
+    localCounts_.resize(nproc);
+    comm.allToAll(dstCounts_, localCounts_);
+    localDispls_.assign(nproc, 0);
+    for (size_t jproc = 1; jproc < nproc; ++jproc) {
+      localDispls_[jproc] = localDispls_[jproc-1] + localCounts_[jproc-1];
+    }
+    localSize_ = static_cast<size_t>(localDispls_[nproc-1] + localCounts_[nproc-1]);
+
+    // Send coordinates of the local destination points to their owner task
+    std::vector<double> sendCoords(2*dstOrder_.size());
+    for (size_t j = 0; j < dstOrder_.size(); ++j) {
+      sendCoords[2*j] = dstPoints[dstOrder_[j]].x();
+      sendCoords[2*j+1] = dstPoints[dstOrder_[j]].y();
+    }
+    std::vector<double> recvCoords(2*localSize_);
+    exchange(sendCoords, dstCounts_, dstDispls_, recvCoords, localCounts_, localDispls_, 2);
+
+    // Unique interpolation points (the same point can be requested by several tasks)
+    std::map<std::pair<double, double>, size_t> uniquePoints;
+    std::vector<atlas::PointXY> points;
+    localIndex_.resize(localSize_);
+    for (size_t j = 0; j < localSize_; ++j) {
+      const std::pair<double, double> xy(recvCoords[2*j], recvCoords[2*j+1]);
+      auto it = uniquePoints.find(xy);
+      if (it == uniquePoints.end()) {
+        it = uniquePoints.insert(std::make_pair(xy, points.size())).first;
+        points.push_back(atlas::PointXY(xy.first, xy.second));
       }
+      localIndex_[j] = it->second;
     }
 
     // Add extra points if needed
@@ -258,44 +326,35 @@ void AtlasInterpWrapper::execute(const atlas::Field & srcField,
 
   if (dstField.functionspace().type() == "PointCloud") {
     // PointCloud destination function space
-    const atlas::functionspace::PointCloud fs(dstField.functionspace());
-    const atlas::functionspace::PointCloud localFs(localDstFunctionSpace_);
-
-    // Global vector initialization
-    std::vector<double> globalData(fs.size()*dstField.levels(), 0.0);
+    const atlas::idx_t levels = dstField.levels();
 
     // Local destination field setup
     atlas::Field localDstField = localDstFunctionSpace_.createField<double>(
-      atlas::option::name(dstField.name()) | atlas::option::levels(dstField.levels()));
+      atlas::option::name(dstField.name()) | atlas::option::levels(levels));
 
     // Interpolation from source field to local destination field
-    interp_.execute(srcTmpField, localDstField);
+    if (localDstFunctionSpace_.size() > 0) {
+      interp_.execute(srcTmpField, localDstField);
+    }
 
-    // Copy of local destination field into global vector
+    // Copy of the values requested by each task into the send buffer
     const auto localDstView = atlas::array::make_view<double, 2>(localDstField);
-    atlas::idx_t globalInc = 0;
-    for (atlas::idx_t k = 0; k < dstField.levels(); ++k) {
-      atlas::idx_t localInc = 0;
-      for (atlas::idx_t i = 0; i < fs.size(); ++i) {
-        if (eckit::mpi::comm().rank() == localTask_[i]) {
-          globalData[globalInc] = localDstView(localInc, k);
-          localInc += 1;
-        }
-        globalInc += 1;
+    std::vector<double> sendBuf(localSize_*levels);
+    for (size_t j = 0; j < localSize_; ++j) {
+      for (atlas::idx_t k = 0; k < levels; ++k) {
+        sendBuf[j*levels+k] = localDstView(localIndex_[j], k);
       }
     }
 
+    // Exchange with the owner tasks
+    std::vector<double> recvBuf(dstOrder_.size()*levels);
+    exchange(sendBuf, localCounts_, localDispls_, recvBuf, dstCounts_, dstDispls_, levels);
 
-    // Sum of global vector over MPI tasks
-    eckit::mpi::comm().allReduceInPlace(globalData.begin(), globalData.end(), eckit::mpi::sum());
-
-    // Copy of global vector into global field
+    // Copy of the receive buffer into the destination field
     auto dstView = atlas::array::make_view<double, 2>(dstField);
-    globalInc = 0;
-    for (atlas::idx_t k = 0; k < dstField.levels(); ++k) {
-      for (atlas::idx_t i = 0; i < fs.size(); ++i) {
-        dstView(i, k) = globalData[globalInc];
-        globalInc += 1;
+    for (size_t j = 0; j < dstOrder_.size(); ++j) {
+      for (atlas::idx_t k = 0; k < levels; ++k) {
+        dstView(dstOrder_[j], k) = recvBuf[j*levels+k];
       }
     }
   } else {
@@ -331,7 +390,40 @@ void AtlasInterpWrapper::executeAdjoint(atlas::Field & srcField,
 
   if (dstField.functionspace().type() == "PointCloud") {
     // PointCloud destination function space
-    ABORT("Adjoint not supported for PointCloud destination function space yet");
+    const atlas::idx_t levels = dstField.levels();
+
+    // Copy of the destination field into the send buffer, grouped by owner task
+    const auto dstView = atlas::array::make_view<double, 2>(dstField);
+    std::vector<double> sendBuf(dstOrder_.size()*levels);
+    for (size_t j = 0; j < dstOrder_.size(); ++j) {
+      for (atlas::idx_t k = 0; k < levels; ++k) {
+        sendBuf[j*levels+k] = dstView(dstOrder_[j], k);
+      }
+    }
+
+    // Exchange with the requesting tasks
+    std::vector<double> recvBuf(localSize_*levels);
+    exchange(sendBuf, dstCounts_, dstDispls_, recvBuf, localCounts_, localDispls_, levels);
+
+    // Local destination field setup (extra points are set to zero, duplicate requests are summed)
+    atlas::Field localDstField = localDstFunctionSpace_.createField<double>(
+      atlas::option::name(dstField.name()) | atlas::option::levels(levels));
+    auto localDstView = atlas::array::make_view<double, 2>(localDstField);
+    localDstView.assign(0.0);
+    for (size_t j = 0; j < localSize_; ++j) {
+      for (atlas::idx_t k = 0; k < levels; ++k) {
+        localDstView(localIndex_[j], k) += recvBuf[j*levels+k];
+      }
+    }
+
+    // Source field initialization
+    auto srcView = atlas::array::make_view<double, 2>(srcField);
+    srcView.assign(0.0);
+
+    // Adjoint interpolation from local destination field to source field
+    if (localDstFunctionSpace_.size() > 0) {
+      interp_.execute_adjoint(srcField, localDstField);
+    }
   } else {
     // Other destination function space
 
@@ -392,6 +484,34 @@ void AtlasInterpWrapper::executeAdjoint(atlas::FieldSet & srcFieldSet,
 
 // -----------------------------------------------------------------------------
 
+void AtlasInterpWrapper::exchange(const std::vector<double> & sendBuf,
+                                  const std::vector<int> & sendCounts,
+                                  const std::vector<int> & sendDispls,
+                                  std::vector<double> & recvBuf,
+                                  const std::vector<int> & recvCounts,
+                                  const std::vector<int> & recvDispls,
+                                  const atlas::idx_t blockSize) const {
+  // Point-to-point exchange with the tasks that actually share points
+  const eckit::mpi::Comm & comm = eckit::mpi::comm();
+  const size_t bs = static_cast<size_t>(blockSize);
+  std::vector<eckit::mpi::Request> requests;
+  for (size_t jproc = 0; jproc < comm.size(); ++jproc) {
+    if (recvCounts[jproc] > 0) {
+      requests.push_back(comm.iReceive(recvBuf.data() + recvDispls[jproc]*bs,
+                                       recvCounts[jproc]*bs, jproc, exchangeTag_));
+    }
+  }
+  for (size_t jproc = 0; jproc < comm.size(); ++jproc) {
+    if (sendCounts[jproc] > 0) {
+      requests.push_back(comm.iSend(sendBuf.data() + sendDispls[jproc]*bs,
+                                    sendCounts[jproc]*bs, jproc, exchangeTag_));
+    }
+  }
+  comm.waitAll(requests);
+}
+
+// -----------------------------------------------------------------------------
+
 }  // namespace interpolation
 }  // namespace saber
 
@@ -8,13 +8,17 @@
 #ifndef SABER_OOPS_ERRORCOVARIANCE_H_
 #define SABER_OOPS_ERRORCOVARIANCE_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "atlas/field.h"
 
+#include "oops/assimilation/GMRESR.h"
+#include "oops/assimilation/PCG.h"
 #include "oops/base/Geometry.h"
+#include "oops/base/IdentityMatrix.h"
 #include "oops/base/Increment.h"
 #include "oops/base/ModelSpaceCovarianceBase.h"
 #include "oops/base/ModelSpaceCovarianceParametersBase.h"
@@ -23,12 +27,15 @@
 #include "oops/util/abor1_cpp.h"
 #include "oops/util/Logger.h"
 #include "oops/util/ObjectCounter.h"
+#include "oops/util/parameters/OptionalParameter.h"
+#include "oops/util/parameters/Parameter.h"
 #include "oops/util/parameters/Parameters.h"
 #include "oops/util/parameters/RequiredParameter.h"
 #include "oops/util/Printable.h"
 #include "oops/util/Timer.h"
 
 #include "saber/oops/SaberBlockBase.h"
+#include "saber/oops/SaberBlockChain.h"
 #include "saber/oops/SaberBlockParametersBase.h"
 
 namespace eckit {
@@ -44,6 +51,25 @@ namespace saber {
 
 // -------------------------------------------------------------------------------------------------
 
+class InverseSolverParameters : public oops::Parameters {
+  OOPS_CONCRETE_PARAMETERS(InverseSolverParameters, Parameters)
+ public:
+  // Solver for the central block inverse: "GMRESR", "PCG" (symmetric positive definite central
+  // block) or "block-wise" (inverse implemented by the central block itself)
+  oops::Parameter<std::string> solver{"solver", "GMRESR", this};
+  // Maximum number of iterations
+  oops::Parameter<int> maxIterations{"maximum iterations", 10, this};
+  // Relative residual norm reduction
+  oops::Parameter<double> tolerance{"tolerance", 1.0e-3, this};
+  // Preconditioner: "identity" or "scaling" (multiplication by a constant)
+  oops::Parameter<std::string> preconditioner{"preconditioner", "identity", this};
+  // Scaling factor of the "scaling" preconditioner (approximate inverse of the central block
+  // variance)
+  oops::Parameter<double> preconditionerScaling{"preconditioner scaling", 1.0, this};
+};
+
+// -----------------------------------------------------------------------------
+
 template <typename MODEL>
 class ErrorCovarianceParameters : public oops::ModelSpaceCovarianceParametersBase<MODEL> {
   OOPS_CONCRETE_PARAMETERS(ErrorCovarianceParameters,
@@ -51,6 +77,25 @@ class ErrorCovarianceParameters : public oops::ModelSpaceCovarianceParametersBas
  public:
   oops::RequiredParameter<std::vector<SaberBlockParametersWrapper<MODEL>>>
       saberBlocks{"saber blocks", this};
+  oops::OptionalParameter<InverseSolverParameters> inverseSolver{"inverse solver", this};
+};
+
+// -----------------------------------------------------------------------------
+
+/// Scaled identity preconditioner for the central block iterative inverse
+template <typename MODEL>
+class ScaledIdentityMatrix {
+  typedef oops::Increment<MODEL> Increment_;
+
+ public:
+  explicit ScaledIdentityMatrix(const double scaling) : scaling_(scaling) {}
+  void multiply(const Increment_ & dxi, Increment_ & dxo) const {
+    dxo = dxi;
+    dxo *= scaling_;
+  }
+
+ private:
+  const double scaling_;
 };
 
 // -----------------------------------------------------------------------------
@@ -92,8 +137,20 @@ class ErrorCovariance : public oops::ModelSpaceCovarianceBase<MODEL>,
 
   void print(std::ostream &) const override;
 
+  template <typename PMATRIX>
+  double solve(Increment_ &, const Increment_ &, const PMATRIX &) const;
+
   std::unique_ptr<SaberBlockBase_> saberCentralBlock_;
   SaberBlockVec_ saberBlocks_;
+  std::unique_ptr<SaberBlockChain<MODEL>> saberBlockChain_;
+
+  // Central block inverse solver
+  InverseSolverParameters inverseSolver_;
+  mutable std::unique_ptr<Increment_> inverseRhs_;
+  mutable size_t inverseCalls_;
+  mutable size_t inverseNotConverged_;
+  mutable double inverseReductionSum_;
+  mutable double inverseReductionMax_;
 };
 
 // -----------------------------------------------------------------------------
@@ -104,7 +161,8 @@ ErrorCovariance<MODEL>::ErrorCovariance(const Geometry_ & resol,
                                         const Parameters_ & params,
                                         const State_ & xb, const State_ & fg)
   : oops::ModelSpaceCovarianceBase<MODEL>(resol, params, xb, fg), saberCentralBlock_(),
-    saberBlocks_()
+    saberBlocks_(), saberBlockChain_(), inverseSolver_(), inverseRhs_(), inverseCalls_(0),
+    inverseNotConverged_(0), inverseReductionSum_(0.0), inverseReductionMax_(0.0)
 {
   oops::Log::trace() << "ErrorCovariance::ErrorCovariance starting" << std::endl;
 
@@ -146,6 +204,34 @@ ErrorCovariance<MODEL>::ErrorCovariance(const Geometry_ & resol,
     }
   }
 
+  // Block chain for randomization and multiplication
+  saberBlockChain_.reset(new SaberBlockChain<MODEL>(saberCentralBlock_.get(), saberBlocks_));
+
+  // Central block inverse solver
+  if (params.inverseSolver.value() != boost::none) {
+    inverseSolver_ = *params.inverseSolver.value();
+  }
+  const std::string & solver = inverseSolver_.solver.value();
+  if (solver != "GMRESR" && solver != "PCG" && solver != "block-wise") {
+    ABORT("Wrong inverse solver: " + solver);
+  }
+  const std::string & preconditioner = inverseSolver_.preconditioner.value();
+  if (preconditioner != "identity" && preconditioner != "scaling") {
+    ABORT("Wrong inverse solver preconditioner: " + preconditioner);
+  }
+  if (inverseSolver_.maxIterations.value() < 1) {
+    ABORT("Inverse solver maximum iterations should be positive");
+  }
+  if (saberCentralBlock_) {
+    if (solver == "block-wise" && !saberCentralBlock_->hasInverse()) {
+      ABORT("Block-wise inverse solver requires a central block implementing inverseMultiply");
+    }
+    if (params.inverseSolver.value() != boost::none && solver != "block-wise"
+        && !saberCentralBlock_->iterativeInverse()) {
+      ABORT("Inverse solver " + solver + " requires \"iterative inverse\" in the central block");
+    }
+  }
+
   oops::Log::trace() << "ErrorCovariance::ErrorCovariance done" << std::endl;
 }
 
@@ -155,6 +241,14 @@ template<typename MODEL>
 ErrorCovariance<MODEL>::~ErrorCovariance() {
   oops::Log::trace() << "ErrorCovariance<MODEL>::~ErrorCovariance starting" << std::endl;
   util::Timer timer(classname(), "~ErrorCovariance");
+  if (inverseCalls_ > 0) {
+    oops::Log::info() << "Central block inverse (" << inverseSolver_.solver.value() << "): "
+                      << inverseCalls_ << " calls, mean residual reduction "
+                      << inverseReductionSum_/static_cast<double>(inverseCalls_)
+                      << ", max residual reduction " << inverseReductionMax_ << ", "
+                      << inverseNotConverged_ << " calls above tolerance" << std::endl;
+  }
+  saberBlockChain_.reset();
   oops::Log::trace() << "ErrorCovariance<MODEL>::~ErrorCovariance done" << std::endl;
 }
 
@@ -168,24 +262,8 @@ void ErrorCovariance<MODEL>::doRandomize(Increment_ & dx) const {
   // Random output vector (necessary for some SABER blocks)
   dx.random();
 
-  // Randomization done flag
-  bool randDone(false);
-
-  // Central block randomization
-  if (saberCentralBlock_) {
-    saberCentralBlock_->randomize(dx.fieldSet());
-    randDone = true;
-  }
-
-  // K_N K_N-1 ... K_1
-  for (icst_ it = saberBlocks_.begin(); it != saberBlocks_.end(); ++it) {
-    if (!randDone) {
-      it->randomize(dx.fieldSet());
-      randDone = true;
-    } else {
-      it->multiply(dx.fieldSet());
-    }
-  }
+  // C^1/2 or K_N K_N-1 ... K_1 C^1/2
+  saberBlockChain_->randomize(dx.fieldSet());
 
   // ATLAS fieldset to Increment_
   dx.synchronizeFields();
@@ -204,20 +282,8 @@ void ErrorCovariance<MODEL>::doMultiply(const Increment_ & dxi,
   // Copy input
   dxo = dxi;
 
-  // K_1^T K_2^T .. K_N^T
-  for (ircst_ it = saberBlocks_.rbegin(); it != saberBlocks_.rend(); ++it) {
-    it->multiplyAD(dxo.fieldSet());
-  }
-
-  // Central block multiplication
-  if (saberCentralBlock_) {
-    saberCentralBlock_->multiply(dxo.fieldSet());
-  }
-
-  // K_N K_N-1 ... K_1
-  for (icst_ it = saberBlocks_.begin(); it != saberBlocks_.end(); ++it) {
-    it->multiply(dxo.fieldSet());
-  }
+  // K_N K_N-1 ... K_1 C K_1^T K_2^T .. K_N^T
+  saberBlockChain_->multiply(dxo.fieldSet());
 
   // ATLAS fieldset to Increment_
   dxo.synchronizeFields();
@@ -246,7 +312,7 @@ void ErrorCovariance<MODEL>::doInverseMultiply(const Increment_ & dxi,
 
   // Central block inverse multiplication
   if (saberCentralBlock_) {
-    if (saberCentralBlock_->iterativeInverse()) {
+    if (saberCentralBlock_->iterativeInverse() && inverseSolver_.solver.value() != "block-wise") {
       if (saberBlocks_.size() > 0) {
         // ATLAS fieldset to Increment_
         dxo.synchronizeFields();
@@ -254,13 +320,31 @@ void ErrorCovariance<MODEL>::doInverseMultiply(const Increment_ & dxi,
         syncNeeded = false;
       }
 
-      // Temporary increment
-      Increment_ dxtmp(dxo);
+      // Right-hand side (allocated once)
+      if (inverseRhs_) {
+        *inverseRhs_ = dxo;
+      } else {
+        inverseRhs_.reset(new Increment_(dxo));
+      }
 
       // Iterative inverse
-      oops::IdentityMatrix<Increment_> Id;
       dxo.zero();
-      GMRESR(dxo, dxtmp, *this, Id, 10, 1.0e-3);
+      double reduction;
+      if (inverseSolver_.preconditioner.value() == "scaling") {
+        const ScaledIdentityMatrix<MODEL> precond(inverseSolver_.preconditionerScaling.value());
+        reduction = solve(dxo, *inverseRhs_, precond);
+      } else {
+        oops::IdentityMatrix<Increment_> precond;
+        reduction = solve(dxo, *inverseRhs_, precond);
+      }
+
+      // Convergence statistics
+      inverseCalls_++;
+      inverseReductionSum_ += reduction;
+      inverseReductionMax_ = std::max(inverseReductionMax_, reduction);
+      if (reduction > inverseSolver_.tolerance.value()) inverseNotConverged_++;
+      oops::Log::info() << "Central block inverse (" << inverseSolver_.solver.value()
+                        << "): residual reduction " << reduction << std::endl;
     } else {
       // Block-specific inverse
       saberCentralBlock_->inverseMultiply(dxo.fieldSet());
@@ -306,6 +390,22 @@ void ErrorCovariance<MODEL>::multiply(const Increment_ & dxi,
 
 // -----------------------------------------------------------------------------
 
+template<typename MODEL>
+template <typename PMATRIX>
+double ErrorCovariance<MODEL>::solve(Increment_ & dx,
+                                     const Increment_ & rhs,
+                                     const PMATRIX & precond) const {
+  const int maxIterations = inverseSolver_.maxIterations.value();
+  const double tolerance = inverseSolver_.tolerance.value();
+  if (inverseSolver_.solver.value() == "PCG") {
+    return PCG(dx, rhs, *this, precond, maxIterations, tolerance);
+  } else {
+    return GMRESR(dx, rhs, *this, precond, maxIterations, tolerance);
+  }
+}
+
+// -----------------------------------------------------------------------------
+
 template<typename MODEL>
 void ErrorCovariance<MODEL>::print(std::ostream & os) const {
   oops::Log::trace() << "ErrorCovariance<MODEL>::print starting" << std::endl;
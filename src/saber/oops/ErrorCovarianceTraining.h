@@ -11,6 +11,8 @@
 #include <memory>
 #include <string>
 
+#include "eckit/mpi/Comm.h"
+
 #include "oops/base/Increment.h"
 #include "oops/base/IncrementEnsemble.h"
 #include "oops/base/ModelSpaceCovarianceBase.h"
@@ -251,8 +253,34 @@ template <typename MODEL> class ErrorCovarianceTraining : public oops::Applicati
     // BUMP
     const boost::optional<BUMP_Parameters<MODEL>> &bumpParams = params.bumpParams.value();
     if (bumpParams != boost::none) {
+      // Geometries on a duplicated communicator, for the ensemble members read ahead by BUMP
+      const std::string commIOName = "saber_bump_prefetch";
+      std::unique_ptr<const Geometry_> geomIO1;
+      std::unique_ptr<const Geometry_> geomIO2;
+      const boost::optional<int> &ensemblePrefetch = bumpParams->ensemblePrefetch.value();
+      if (ensemblePrefetch != boost::none && *ensemblePrefetch > 0) {
+        const eckit::mpi::Comm & commIO = geom1.getComm().split(0, commIOName);
+        geomIO1.reset(new Geometry_(params.geometry, commIO));
+        if (geom2Params != boost::none) {
+          geomIO2.reset(new Geometry_(*geom2Params, commIO));
+        } else {
+          geomIO2.reset(new Geometry_(params.geometry, commIO));
+        }
+        eckit::mpi::setCommDefault(geom1.getComm().name().c_str());
+      }
+
       // Do training
-      BUMP_ bump(geom1, *geom2, inputVars, *bumpParams, xx, xx, ens1, ens2);
+      {
+        BUMP_ bump(geom1, *geom2, inputVars, *bumpParams, xx, xx, ens1, ens2, geomIO1.get(),
+                   geomIO2.get());
+      }
+
+      // Release the duplicated communicator
+      if (geomIO1) {
+        geomIO1.reset();
+        geomIO2.reset();
+        eckit::mpi::deleteComm(commIOName.c_str());
+      }
     }
 
     // Delete pointer
@@ -0,0 +1,113 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef SABER_OOPS_FIELDSETPOOL_H_
+#define SABER_OOPS_FIELDSETPOOL_H_
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+
+#include "oops/util/Logger.h"
+
+namespace saber {
+
+// -----------------------------------------------------------------------------
+
+/// \details FieldSetPool keeps work FieldSets alive between calls, so that a block changing
+///          the function space of its fields allocates them once instead of at each
+///          application. A pooled FieldSet is reallocated when the requested layout changes:
+///          another function space object (not only another type or size, so that different
+///          partitions or halos never share fields), other field names or levels. Pooled
+///          fields are reused at the next request with the same key only if nobody else
+///          holds them anymore: fields still referenced by a caller are left to it and new
+///          fields are allocated, so that a handle returned by get() is never overwritten.
+class FieldSetPool {
+ public:
+  FieldSetPool() {}
+
+  /// \details get() returns a new FieldSet holding the pooled fields for this key, with the
+  ///          fields of like (names and levels) on the function space fs. Values are not
+  ///          initialized.
+  atlas::FieldSet get(const std::string & key,
+                      const atlas::FunctionSpace & fs,
+                      const atlas::FieldSet & like) {
+    const std::string layout = layoutSignature(like);
+    Entry & entry = pool_[key];
+    if (entry.fs.get() != fs.get() || entry.layout != layout || inUse(entry.fset)) {
+      oops::Log::trace() << "FieldSetPool::get allocating " << key << std::endl;
+      entry.fset = atlas::FieldSet();
+      for (const auto & field : like) {
+        entry.fset.add(fs.createField<double>(atlas::option::name(field.name()) |
+                                              atlas::option::levels(field.levels())));
+      }
+      entry.fs = fs;
+      entry.layout = layout;
+    }
+
+    // The caller gets its own FieldSet, sharing the pooled fields
+    atlas::FieldSet fset;
+    for (const auto & field : entry.fset) {
+      fset.add(field);
+    }
+    return fset;
+  }
+
+  /// \details bytes() returns the memory held by the pool.
+  std::size_t bytes() const {
+    std::size_t total(0);
+    for (const auto & entry : pool_) {
+      total += bytes(entry.second.fset);
+    }
+    return total;
+  }
+
+  void clear() {pool_.clear();}
+
+  /// \details bytes() returns the memory held by the fields of a FieldSet.
+  static std::size_t bytes(const atlas::FieldSet & fset) {
+    std::size_t total(0);
+    for (const auto & field : fset) {
+      total += field.bytes();
+    }
+    return total;
+  }
+
+ private:
+  struct Entry {
+    atlas::FunctionSpace fs;
+    std::string layout;
+    atlas::FieldSet fset;
+  };
+
+  static std::string layoutSignature(const atlas::FieldSet & fset) {
+    std::ostringstream os;
+    for (const auto & field : fset) {
+      os << field.name() << ":" << field.levels() << ";";
+    }
+    return os.str();
+  }
+
+  /// \details inUse() checks whether pooled fields are still referenced outside of the pool.
+  static bool inUse(const atlas::FieldSet & fset) {
+    for (const auto & field : fset) {
+      if (field.owners() > 1) return true;
+    }
+    return false;
+  }
+
+  std::map<std::string, Entry> pool_;
+};
+
+// -----------------------------------------------------------------------------
+
+}  // namespace saber
+
+#endif  // SABER_OOPS_FIELDSETPOOL_H_
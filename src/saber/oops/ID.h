@@ -54,6 +54,8 @@ class ID : public SaberBlockBase<MODEL> {
   void multiplyAD(atlas::FieldSet &) const override;
   void inverseMultiplyAD(atlas::FieldSet &) const override;
 
+  bool isIdentity() const override {return true;}
+
  private:
   void print(std::ostream &) const override;
 };
@@ -8,9 +8,23 @@
 #ifndef SABER_OOPS_RANDOMIZATION_H_
 #define SABER_OOPS_RANDOMIZATION_H_
 
+#include <mpi.h>
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+
+#include "eckit/mpi/Comm.h"
 
+#include "oops/base/Geometry.h"
 #include "oops/base/Increment.h"
 #include "oops/base/ModelSpaceCovarianceBase.h"
 #include "oops/base/State.h"
@@ -18,7 +32,9 @@
 #include "oops/base/Variables.h"
 #include "oops/mpi/mpi.h"
 #include "oops/runs/Application.h"
+#include "oops/util/abor1_cpp.h"
 #include "oops/util/Logger.h"
+#include "oops/util/parameters/Parameter.h"
 #include "oops/util/parameters/RequiredParameter.h"
 
 #include "saber/oops/instantiateCovarFactory.h"
@@ -60,6 +76,136 @@ template <typename MODEL> class RandomizationParameters
 
   /// Where to write the output
   oops::RequiredParameter<StateWriterParameters_> output{"output", this};
+
+  /// Maximum number of perturbed states waiting to be written by the background writer
+  /// (0: members are written synchronously, requires MPI_THREAD_MULTIPLE otherwise). Members
+  /// are still generated and written one at a time.
+  oops::Parameter<int> writeQueue{"write queue size", 0, this};
+};
+
+// -----------------------------------------------------------------------------
+/// Perturbed states writer. With nQueue > 0, the output of member n overlaps the generation of
+/// the following members: states are handed to a background thread and written in order, and
+/// the generation blocks when nQueue states are pending. Each state is still written on its
+/// own, there is no batching of several members into one output or communication round (the
+/// covariance randomize interface produces a single increment per call).
+///
+/// State::write typically gathers the field on the I/O tasks while B^{1/2} runs its own
+/// collectives on the main thread, so the queue requires MPI_THREAD_MULTIPLE, and the queued
+/// states have to be defined on a geometry with its own (duplicated) communicator.
+template<typename MODEL> class RandomizationWriter {
+  typedef oops::Geometry<MODEL>               Geometry_;
+  typedef oops::State<MODEL>                  State_;
+  typedef oops::StateWriterParameters<State_> StateWriterParameters_;
+
+ public:
+  RandomizationWriter(const StateWriterParameters_ & params, const int & nQueue,
+                      const Geometry_ & geom, const Geometry_ * geomIO = NULL)
+    : params_(params), nQueue_(nQueue > 0 ? static_cast<size_t>(nQueue) : 0), nWritten_(0),
+      done_(false), error_() {
+    if (nQueue_ > 0) {
+      // Background collectives
+      int provided;
+      MPI_Query_thread(&provided);
+      if (provided != MPI_THREAD_MULTIPLE) {
+        ABORT("Randomization: write queue requires MPI_THREAD_MULTIPLE (set "
+              "ECKIT_MPI_INIT_THREAD)");
+      }
+
+      // Background writes need their own communicator
+      if (geomIO == NULL || &geomIO->getComm() == &geom.getComm()) {
+        ABORT("Randomization: write queue requires a geometry on a duplicated communicator");
+      }
+
+      // Start the writer
+      thread_ = std::thread(&RandomizationWriter::writeLoop, this);
+      oops::Log::info() << "Randomization: up to " << nQueue_ << " member(s) queued for "
+                        << "writing" << std::endl;
+    }
+  }
+
+  ~RandomizationWriter() {
+    if (thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+      }
+      cond_.notify_all();
+      thread_.join();
+    }
+  }
+
+  /// Write (or queue) a perturbed state
+  void write(std::unique_ptr<State_> xp, const size_t & member) {
+    if (thread_.joinable()) {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      // Wait for room in the queue
+      cond_.wait(lock, [this] {return queue_.size() < nQueue_ || error_;});
+      if (error_) std::rethrow_exception(error_);
+      queue_.emplace_back(member, std::move(xp));
+      cond_.notify_all();
+    } else {
+      writeState(*xp, member);
+    }
+  }
+
+  /// Wait for all the queued states to be written
+  void finish() {
+    if (thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+      }
+      cond_.notify_all();
+      thread_.join();
+      if (error_) std::rethrow_exception(error_);
+      oops::Log::info() << "Randomization: " << nWritten_ << " member(s) written by the "
+                        << "background writer" << std::endl;
+    }
+  }
+
+ private:
+  void writeState(const State_ & xp, const size_t & member) const {
+    StateWriterParameters_ outParams = params_;
+    outParams.write.setMember(member);
+    xp.write(outParams.write);
+  }
+
+  void writeLoop() {
+    try {
+      while (true) {
+        std::pair<size_t, std::unique_ptr<State_>> item;
+        {
+          // Wait for a state to write
+          std::unique_lock<std::mutex> lock(mutex_);
+          cond_.wait(lock, [this] {return !queue_.empty() || done_;});
+          if (queue_.empty()) return;
+          item = std::move(queue_.front());
+          queue_.pop_front();
+        }
+        cond_.notify_all();
+        writeState(*item.second, item.first);
+        ++nWritten_;
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+      }
+      cond_.notify_all();
+    }
+  }
+
+  const StateWriterParameters_ params_;
+  const size_t nQueue_;
+  size_t nWritten_;
+  std::deque<std::pair<size_t, std::unique_ptr<State_>>> queue_;
+  bool done_;
+  std::exception_ptr error_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread thread_;
 };
 
 // -----------------------------------------------------------------------------
@@ -106,21 +252,54 @@ template <typename MODEL> class Randomization : public oops::Application {
     std::unique_ptr<CovarianceBase_> Bmat(CovarianceFactory_::create(
                                           geom, vars, covarParams, xx, xx));
 
-    // Generate and write perturbations
-    Increment_ dx(geom, vars, xx.validTime());
-    for (size_t jm = 0; jm < covarParams.randomizationSize.value(); ++jm) {
-      // Generate pertubation
-      Bmat->randomize(dx);
-      oops::Log::test() << "Member " << jm << ": " << dx << std::endl;
-
-      // Add mean state
-      State_ xp(xx);
-      xp += dx;
-
-      // Write perturbation
-      StateWriterParameters_ outParams = params.output;
-      outParams.write.setMember(jm+1);
-      xp.write(outParams.write);
+    // Geometry and background state on a duplicated communicator, for the queued writes
+    const std::string commIOName = "saber_randomization_write";
+    std::unique_ptr<const Geometry_> geomIO;
+    std::unique_ptr<const State_> xxIO;
+    if (params.writeQueue.value() > 0) {
+      const eckit::mpi::Comm & commIO = geom.getComm().split(0, commIOName);
+      geomIO.reset(new Geometry_(params.geometry, commIO));
+      eckit::mpi::setCommDefault(geom.getComm().name().c_str());
+      xxIO.reset(new State_(*geomIO, params.background));
+    }
+
+    {
+      // Perturbed states writer
+      RandomizationWriter<MODEL> writer(params.output, params.writeQueue.value(), geom,
+                                        geomIO.get());
+
+      // Generate and write perturbations
+      Increment_ dx(geom, vars, xx.validTime());
+      for (size_t jm = 0; jm < covarParams.randomizationSize.value(); ++jm) {
+        // Generate pertubation
+        Bmat->randomize(dx);
+        oops::Log::test() << "Member " << jm << ": " << dx << std::endl;
+
+        // Add mean state
+        std::unique_ptr<State_> xp;
+        if (geomIO) {
+          Increment_ dxIO(*geomIO, vars, xx.validTime());
+          copyIncrement(dx, dxIO);
+          xp.reset(new State_(*xxIO));
+          *xp += dxIO;
+        } else {
+          xp.reset(new State_(xx));
+          *xp += dx;
+        }
+
+        // Write perturbation (in the background if the queue is enabled)
+        writer.write(std::move(xp), jm+1);
+      }
+
+      // Wait for the last writes
+      writer.finish();
+    }
+
+    // Release the duplicated communicator
+    if (geomIO) {
+      xxIO.reset();
+      geomIO.reset();
+      eckit::mpi::deleteComm(commIOName.c_str());
     }
 
     return 0;
@@ -130,6 +309,22 @@ template <typename MODEL> class Randomization : public oops::Application {
   std::string appname() const override {
     return "saber::Randomization<" + MODEL::name() + ">";
   }
+
+  /// Local copy between increments with the same layout on different communicators
+  static void copyIncrement(Increment_ & dxi, Increment_ & dxo) {
+    for (auto & fieldi : dxi.fieldSet()) {
+      atlas::Field fieldo = dxo.fieldSet()[fieldi.name()];
+      ASSERT(fieldo.shape(0) == fieldi.shape(0) && fieldo.shape(1) == fieldi.shape(1));
+      auto viewi = atlas::array::make_view<double, 2>(fieldi);
+      auto viewo = atlas::array::make_view<double, 2>(fieldo);
+      for (atlas::idx_t jnode = 0; jnode < fieldi.shape(0); ++jnode) {
+        for (atlas::idx_t jlevel = 0; jlevel < fieldi.shape(1); ++jlevel) {
+          viewo(jnode, jlevel) = viewi(jnode, jlevel);
+        }
+      }
+    }
+    dxo.synchronizeFields();
+  }
 };
 
 // -----------------------------------------------------------------------------
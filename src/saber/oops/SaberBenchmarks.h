@@ -0,0 +1,382 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef SABER_OOPS_SABERBENCHMARKS_H_
+#define SABER_OOPS_SABERBENCHMARKS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atlas/array/MakeView.h"
+#include "atlas/field/Field.h"
+#include "atlas/field/FieldSet.h"
+#include "atlas/functionspace/StructuredColumns.h"
+#include "atlas/grid/Grid.h"
+#include "atlas/grid/Partitioner.h"
+
+#include "eckit/log/JSON.h"
+#include "eckit/log/Timer.h"
+#include "eckit/mpi/Comm.h"
+
+#include "oops/base/Increment.h"
+#include "oops/base/State.h"
+#include "oops/base/Variables.h"
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Application.h"
+#include "oops/util/Logger.h"
+#include "oops/util/parameters/OptionalParameter.h"
+#include "oops/util/parameters/Parameter.h"
+#include "oops/util/parameters/Parameters.h"
+#include "oops/util/parameters/RequiredParameter.h"
+#include "oops/util/Timer.h"
+
+#include "saber/interpolation/AtlasInterpWrapper.h"
+#include "saber/oops/SaberBlockBase.h"
+#include "saber/oops/SaberBlockParametersBase.h"
+#if atlas_TRANS_FOUND
+  #include "saber/spectralb/spectralb.h"
+  #include "saber/spectralb/SpectralVerticalKernel.h"
+#endif
+
+namespace eckit {
+  class Configuration;
+}
+
+namespace saber {
+
+// -----------------------------------------------------------------------------
+
+/// Standalone kernels benchmark parameters
+class KernelBenchmarkParameters : public oops::Parameters {
+  OOPS_CONCRETE_PARAMETERS(KernelBenchmarkParameters, oops::Parameters)
+
+ public:
+  /// Gaussian grid name (e.g. "F32"), source grid of the kernels
+  oops::RequiredParameter<std::string> gaussGrid{"gauss grid", this};
+
+  /// Destination grid name of the interpolation (default: Gaussian grid)
+  oops::OptionalParameter<std::string> interpolationGrid{"interpolation grid", this};
+
+  /// Number of levels
+  oops::Parameter<size_t> levels{"levels", 10, this};
+
+  /// Number of fields
+  oops::Parameter<size_t> fields{"fields", 1, this};
+};
+
+// -----------------------------------------------------------------------------
+
+template <typename MODEL> class SaberBenchmarksParameters
+  : public oops::ApplicationParameters {
+  OOPS_CONCRETE_PARAMETERS(SaberBenchmarksParameters, oops::ApplicationParameters)
+
+ public:
+  typedef typename oops::Geometry<MODEL>::Parameters_ GeometryParameters_;
+  typedef typename oops::State<MODEL>::Parameters_    StateParameters_;
+
+  /// Geometry parameters
+  oops::RequiredParameter<GeometryParameters_> geometry{"geometry", this};
+
+  /// Benchmarked variables
+  oops::RequiredParameter<oops::Variables> variables{"variables", this};
+
+  /// Background parameters
+  oops::RequiredParameter<StateParameters_> background{"background", this};
+
+  /// Benchmarked SABER blocks
+  oops::OptionalParameter<std::vector<SaberBlockParametersWrapper<MODEL>>>
+    saberBlocks{"saber blocks", this};
+
+  /// Benchmarked standalone kernels
+  oops::OptionalParameter<std::vector<KernelBenchmarkParameters>> kernels{"kernels", this};
+
+  /// Number of warm-up applications (not timed)
+  oops::Parameter<size_t> warmUp{"warm-up", 2, this};
+
+  /// Number of timed repetitions
+  oops::Parameter<size_t> repetitions{"repetitions", 10, this};
+
+  /// Output JSON file
+  oops::Parameter<std::string> output{"output file", "saber_benchmarks.json", this};
+};
+
+// -----------------------------------------------------------------------------
+
+/// Timings of a benchmarked operation (maximum over MPI tasks, for each repetition)
+struct BenchmarkResult {
+  std::string target;
+  std::string operation;
+  std::string size;
+  bool done;
+  std::vector<double> times;
+};
+
+// -----------------------------------------------------------------------------
+
+/// \details SaberBenchmarks times the SABER blocks methods (multiply, multiplyAD,
+///          inverseMultiply and randomize) on a given model, and some standalone kernels
+///          at configurable grid sizes. Each operation is applied a number of times without
+///          being timed (warm-up), then timed over several repetitions. Statistics are
+///          written in a JSON file. The BUMP Fortran kernels (linop_apply, com_ext) have no
+///          C++ binding and are not benchmarked standalone: they are only timed within the
+///          BUMP blocks, and individually by the probe when instrumentation is enabled.
+template <typename MODEL> class SaberBenchmarks : public oops::Application {
+  typedef oops::Geometry<MODEL>              Geometry_;
+  typedef oops::Increment<MODEL>             Increment_;
+  typedef SaberBlockBase<MODEL>              SaberBlockBase_;
+  typedef SaberBlockParametersWrapper<MODEL> SaberBlockParametersWrapper_;
+  typedef oops::State<MODEL>                 State_;
+  typedef SaberBenchmarksParameters<MODEL>   SaberBenchmarksParameters_;
+
+ public:
+  static const std::string classname() {return "saber::SaberBenchmarks";}
+  explicit SaberBenchmarks(const eckit::mpi::Comm & comm = oops::mpi::world())
+    : Application(comm) {}
+
+  virtual ~SaberBenchmarks() {}
+
+  int execute(const eckit::Configuration & fullConfig, bool validate) const override {
+    util::Timer timer(classname(), "execute");
+
+    // Deserialize parameters
+    SaberBenchmarksParameters_ params;
+    if (validate) params.validate(fullConfig);
+    params.deserialize(fullConfig);
+    std::vector<BenchmarkResult> results;
+
+    // Setup geometry
+    const Geometry_ geom(params.geometry, this->getComm());
+
+    // Setup variables
+    const oops::Variables vars(params.variables);
+
+    // Setup background state
+    const State_ xx(geom, params.background);
+
+    // SABER blocks
+    if (params.saberBlocks.value() != boost::none) {
+      Increment_ dx(geom, vars, xx.validTime());
+      const std::string size = std::to_string(dx.fieldSet()[0].shape(0)) + " points";
+      for (const SaberBlockParametersWrapper_ & saberBlockParamWrapper :
+           *params.saberBlocks.value()) {
+        const SaberBlockParametersBase & saberBlockParams =
+          saberBlockParamWrapper.saberBlockParameters;
+        std::unique_ptr<SaberBlockBase_> saberBlock(SaberBlockFactory<MODEL>::create(geom,
+          saberBlockParams, xx, xx));
+        const std::string name = saberBlock->name();
+        oops::Log::info() << "Benchmarking block " << name << std::endl;
+
+        const std::function<void()> reset = [&dx]() {dx.random();};
+        results.push_back(benchmark(params, name, "multiply", size, reset,
+          [&]() {saberBlock->multiply(dx.fieldSet());}));
+        results.push_back(benchmark(params, name, "multiplyAD", size, reset,
+          [&]() {saberBlock->multiplyAD(dx.fieldSet());}));
+        results.push_back(benchmark(params, name, "inverseMultiply", size, reset,
+          [&]() {saberBlock->inverseMultiply(dx.fieldSet());}));
+        results.push_back(benchmark(params, name, "randomize", size, []() {},
+          [&]() {saberBlock->randomize(dx.fieldSet());}));
+      }
+    }
+
+    // Standalone kernels
+    if (params.kernels.value() != boost::none) {
+      for (const KernelBenchmarkParameters & kernelParams : *params.kernels.value()) {
+        benchmarkKernels(params, kernelParams, results);
+      }
+    }
+
+    // Write results
+    if (this->getComm().rank() == 0) {
+      std::ofstream out(params.output.value());
+      eckit::JSON json(out);
+      json.precision(9);
+      json.startObject();
+      json << "model" << MODEL::name();
+      json << "tasks" << this->getComm().size();
+      json << "warm-up" << params.warmUp.value();
+      json << "repetitions" << params.repetitions.value();
+      json << "registered blocks";
+      json.startList();
+      for (const std::string & maker : SaberBlockFactory<MODEL>::getMakerNames()) json << maker;
+      json.endList();
+      json << "benchmarks";
+      json.startList();
+      for (const BenchmarkResult & result : results) {
+        json.startObject();
+        json << "target" << result.target;
+        json << "operation" << result.operation;
+        json << "size" << result.size;
+        json << "done" << result.done;
+        if (result.done) {
+          const double n = static_cast<double>(result.times.size());
+          double mean = 0.0;
+          for (const double time : result.times) mean += time;
+          mean /= n;
+          double variance = 0.0;
+          for (const double time : result.times) variance += (time-mean)*(time-mean);
+          variance = (result.times.size() > 1) ? variance/(n-1.0) : 0.0;
+          json << "mean" << mean;
+          json << "variance" << variance;
+          json << "standard deviation" << std::sqrt(variance);
+          json << "min" << *std::min_element(result.times.begin(), result.times.end());
+          json << "max" << *std::max_element(result.times.begin(), result.times.end());
+          json << "times";
+          json.startList();
+          for (const double time : result.times) json << time;
+          json.endList();
+        }
+        json.endObject();
+      }
+      json.endList();
+      json.endObject();
+      out << std::endl;
+      oops::Log::info() << "Benchmarks written in " << params.output.value() << std::endl;
+    }
+
+    return 0;
+  }
+
+ private:
+  /// Time an operation, after some untimed warm-up applications. The reset function is
+  /// called before each application and is not timed. Operations that are not available
+  /// for a given target (exception thrown) are reported as not done.
+  BenchmarkResult benchmark(const SaberBenchmarksParameters_ & params,
+                            const std::string & target,
+                            const std::string & operation,
+                            const std::string & size,
+                            const std::function<void()> & reset,
+                            const std::function<void()> & apply) const {
+    BenchmarkResult result{target, operation, size, true, {}};
+    try {
+      for (size_t jj = 0; jj < params.warmUp.value(); ++jj) {
+        reset();
+        apply();
+      }
+      for (size_t jj = 0; jj < params.repetitions.value(); ++jj) {
+        reset();
+        this->getComm().barrier();
+        eckit::Timer timer;
+        timer.start();
+        apply();
+        double elapsed = timer.elapsed();
+        this->getComm().allReduceInPlace(elapsed, eckit::mpi::max());
+        result.times.push_back(elapsed);
+      }
+      oops::Log::info() << "  " << target << " " << operation << ": "
+                        << result.times.size() << " repetitions" << std::endl;
+    } catch (const std::exception & e) {
+      oops::Log::info() << "  " << target << " " << operation << " not available: " << e.what()
+                        << std::endl;
+      result.done = false;
+      result.times.clear();
+    }
+    return result;
+  }
+
+  /// Benchmark the standalone kernels at a given grid size
+  void benchmarkKernels(const SaberBenchmarksParameters_ & benchParams,
+                        const KernelBenchmarkParameters & params,
+                        std::vector<BenchmarkResult> & results) const {
+    const std::string gaussGridName = params.gaussGrid.value();
+    const std::string dstGridName = params.interpolationGrid.value() != boost::none ?
+      *params.interpolationGrid.value() : gaussGridName;
+    const atlas::idx_t levels = static_cast<atlas::idx_t>(params.levels.value());
+    const size_t nfields = params.fields.value();
+    const std::string size = gaussGridName + ", " + std::to_string(levels) + " levels, "
+      + std::to_string(nfields) + " field(s)";
+    oops::Log::info() << "Benchmarking kernels for " << size << std::endl;
+
+    // Source function space and fields
+    const atlas::StructuredGrid gaussGrid(gaussGridName);
+#if atlas_TRANS_FOUND
+    const atlas::grid::Partitioner partitioner(new TransPartitioner());
+#else
+    const atlas::grid::Partitioner partitioner("equal_regions");
+#endif
+    const atlas::functionspace::StructuredColumns gaussFS(gaussGrid, partitioner,
+      atlas::option::halo(1));
+    atlas::FieldSet gaussFields;
+    for (size_t jf = 0; jf < nfields; ++jf) {
+      gaussFields.add(gaussFS.createField<double>(atlas::option::name("field_"
+        + std::to_string(jf)) | atlas::option::levels(levels)));
+    }
+    const std::function<void()> resetGauss = [&gaussFields]() {
+      for (auto field : gaussFields) {
+        auto view = atlas::array::make_view<double, 2>(field);
+        for (atlas::idx_t jnode = 0; jnode < field.shape(0); ++jnode) {
+          for (atlas::idx_t jlev = 0; jlev < field.shape(1); ++jlev) {
+            view(jnode, jlev) = std::cos(0.001*static_cast<double>(jnode+jlev));
+          }
+        }
+      }
+    };
+
+    // Interpolation
+    const atlas::Grid dstGrid(dstGridName);
+    const atlas::functionspace::StructuredColumns dstFS(dstGrid);
+    atlas::FieldSet dstFields;
+    for (size_t jf = 0; jf < nfields; ++jf) {
+      dstFields.add(dstFS.createField<double>(atlas::option::name("field_"
+        + std::to_string(jf)) | atlas::option::levels(levels)));
+    }
+    const interpolation::AtlasInterpWrapper interp(partitioner, gaussFS, dstGrid, dstFS);
+    results.push_back(benchmark(benchParams, "AtlasInterpWrapper", "execute",
+      size + " to " + dstGridName, resetGauss,
+      [&]() {interp.execute(gaussFields, dstFields);}));
+
+#if atlas_TRANS_FOUND
+    // Spectral B, with synthetic vertical covariances
+    const atlas::functionspace::Spectral specFS(2*atlas::GaussianGrid(gaussGrid).N()-1,
+      atlas::option::levels(levels));
+    const atlas::trans::Trans trans(gaussFS, specFS);
+    atlas::FieldSet specFields;
+    atlas::FieldSet covariances;
+    const int N = specFS.truncation();
+    for (size_t jf = 0; jf < nfields; ++jf) {
+      const std::string name = "field_" + std::to_string(jf);
+      specFields.add(specFS.createField<double>(atlas::option::name(name) |
+        atlas::option::levels(levels)));
+      atlas::Field cov(name, atlas::array::make_datatype<double>(),
+        atlas::array::make_shape(N+1, levels, levels));
+      auto covView = atlas::array::make_view<double, 3>(cov);
+      for (int n1 = 0; n1 <= N; ++n1) {
+        for (atlas::idx_t r = 0; r < levels; ++r) {
+          for (atlas::idx_t c = 0; c < levels; ++c) {
+            covView(n1, r, c) = static_cast<double>(2*n1+1)
+              *std::exp(-0.125*static_cast<double>((r-c)*(r-c)));
+          }
+        }
+      }
+      covariances.add(cov);
+    }
+    const spectralb::SpectralVerticalKernel kernel(covariances, specFS, specFields);
+    results.push_back(benchmark(benchParams, "SpectralB", "applySpectralB", size,
+      resetGauss,
+      [&]() {
+        trans.invtrans_adj(gaussFields, specFields);
+        kernel.apply(specFields);
+        trans.invtrans(specFields, gaussFields);
+      }));
+#endif
+  }
+
+  std::string appname() const override {
+    return "saber::SaberBenchmarks<" + MODEL::name() + ">";
+  }
+};
+
+// -----------------------------------------------------------------------------
+
+}  // namespace saber
+
+#endif  // SABER_OOPS_SABERBENCHMARKS_H_
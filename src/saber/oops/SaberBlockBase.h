@@ -28,6 +28,7 @@
 #include "oops/util/parameters/RequiredPolymorphicParameter.h"
 #include "oops/util/Printable.h"
 
+#include "saber/oops/FieldSetPool.h"
 #include "saber/oops/SaberBlockParametersBase.h"
 
 namespace saber {
@@ -46,19 +47,34 @@ class SaberBlockBase : public util::Printable, private boost::noncopyable {
   virtual void multiplyAD(atlas::FieldSet &) const = 0;
   virtual void inverseMultiplyAD(atlas::FieldSet &) const = 0;
 
+  // Identity blocks are skipped by the block chain
+  virtual bool isIdentity() const {return false;}
+
+  // Blocks without an explicit inverse should return false
+  virtual bool hasInverse() const {return true;}
+
   bool iterativeInverse() const {return iterativeInverse_;}
   const std::string name() const {return name_;}
+
+  // Work FieldSets pool, set by the block chain (fields are copied back at the end of the chain)
+  void setFieldSetPool(FieldSetPool * pool) {fieldSetPool_ = pool;}
+
+ protected:
+  FieldSetPool * fieldSetPool() const {return fieldSetPool_;}
+
  private:
   virtual void print(std::ostream &) const = 0;
   bool iterativeInverse_;
   std::string name_;
+  FieldSetPool * fieldSetPool_;
 };
 
 // -----------------------------------------------------------------------------
 
 template <typename MODEL>
 SaberBlockBase<MODEL>::SaberBlockBase(const SaberBlockParametersBase & params)
-  : iterativeInverse_(params.iterativeInverse.value()), name_(params.saberBlockName.value()) {}
+  : iterativeInverse_(params.iterativeInverse.value()), name_(params.saberBlockName.value()),
+    fieldSetPool_(nullptr) {}
 
 // =============================================================================
 
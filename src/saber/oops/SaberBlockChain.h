@@ -0,0 +1,298 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef SABER_OOPS_SABERBLOCKCHAIN_H_
+#define SABER_OOPS_SABERBLOCKCHAIN_H_
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+#include "atlas/array/MakeView.h"
+#include "atlas/field.h"
+
+#include "eckit/log/Timer.h"
+
+#include "oops/util/abor1_cpp.h"
+#include "oops/util/Logger.h"
+
+#include "saber/oops/FieldSetPool.h"
+#include "saber/oops/SaberBlockBase.h"
+
+namespace saber {
+
+// -----------------------------------------------------------------------------
+
+/// \details SaberBlockChain applies the sequence of SABER blocks of a covariance model
+///          (K_N ... K_1 C K_1^T ... K_N^T) in place on a FieldSet:
+///          - identity blocks are dropped at setup,
+///          - each block gets its own FieldSetPool, so that blocks changing the function space
+///            of their fields reuse the same work fields from one application to the next,
+///          - at the end of the chain, the results are copied back into the original fields
+///            of the caller (unless they are still the same fields), so that pooled fields
+///            never escape the chain,
+///          - the time spent and the fields footprint are accumulated for each block and
+///            reported when the chain is destroyed.
+template <typename MODEL>
+class SaberBlockChain : private boost::noncopyable {
+  typedef SaberBlockBase<MODEL>                SaberBlockBase_;
+  typedef boost::ptr_vector<SaberBlockBase_>   SaberBlockVec_;
+
+ public:
+  static const std::string classname() {return "saber::SaberBlockChain";}
+
+  SaberBlockChain(SaberBlockBase_ *, SaberBlockVec_ &);
+  ~SaberBlockChain();
+
+  void randomize(atlas::FieldSet &) const;
+  void multiply(atlas::FieldSet &) const;
+
+  void report(std::ostream &) const;
+
+ private:
+  struct Stage {
+    SaberBlockBase_ * block;
+    std::string label;
+    mutable std::size_t calls;
+    mutable double seconds;
+    mutable std::size_t bytes;
+  };
+
+  template <typename OP>
+  void apply(const Stage &, atlas::FieldSet &, const OP &) const;
+  void restore(const std::vector<atlas::Field> &, atlas::FieldSet &) const;
+
+  std::vector<std::unique_ptr<FieldSetPool>> pools_;
+  std::unique_ptr<Stage> central_;
+  // Outer blocks K_1 ... K_N (identity blocks included, for randomization)
+  std::vector<Stage> forward_;
+  // Adjoint outer blocks K_N^T ... K_1^T (identity blocks excluded)
+  std::vector<Stage> adjoint_;
+};
+
+// -----------------------------------------------------------------------------
+
+template<typename MODEL>
+SaberBlockChain<MODEL>::SaberBlockChain(SaberBlockBase_ * centralBlock,
+                                        SaberBlockVec_ & outerBlocks)
+  : pools_(), central_(), forward_(), adjoint_()
+{
+  oops::Log::trace() << classname() << "::SaberBlockChain starting" << std::endl;
+
+  // Central block
+  if (centralBlock) {
+    pools_.emplace_back(new FieldSetPool());
+    centralBlock->setFieldSetPool(pools_.back().get());
+    central_.reset(new Stage{centralBlock, centralBlock->name(), 0, 0.0, 0});
+  }
+
+  // Outer blocks
+  for (SaberBlockBase_ & block : outerBlocks) {
+    if (!block.isIdentity()) {
+      pools_.emplace_back(new FieldSetPool());
+      block.setFieldSetPool(pools_.back().get());
+    }
+    forward_.push_back(Stage{&block, block.name(), 0, 0.0, 0});
+  }
+  for (auto it = forward_.rbegin(); it != forward_.rend(); ++it) {
+    if (!it->block->isIdentity()) {
+      adjoint_.push_back(Stage{it->block, it->label + " (adjoint)", 0, 0.0, 0});
+    }
+  }
+
+  oops::Log::trace() << classname() << "::SaberBlockChain done" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename MODEL>
+SaberBlockChain<MODEL>::~SaberBlockChain() {
+  oops::Log::trace() << classname() << "::~SaberBlockChain starting" << std::endl;
+  report(oops::Log::info());
+  if (central_) central_->block->setFieldSetPool(nullptr);
+  for (const Stage & stage : forward_) {
+    stage.block->setFieldSetPool(nullptr);
+  }
+  oops::Log::trace() << classname() << "::~SaberBlockChain done" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename MODEL>
+void SaberBlockChain<MODEL>::randomize(atlas::FieldSet & fset) const {
+  oops::Log::trace() << classname() << "::randomize starting" << std::endl;
+
+  // Original fields
+  const std::vector<atlas::Field> originals(fset.begin(), fset.end());
+
+  // Randomization done flag
+  bool randDone(false);
+
+  // Central block randomization
+  if (central_) {
+    apply(*central_, fset, [](const SaberBlockBase_ & block, atlas::FieldSet & fs)
+                           {block.randomize(fs);});
+    randDone = true;
+  }
+
+  // K_N K_N-1 ... K_1
+  for (const Stage & stage : forward_) {
+    if (stage.block->isIdentity()) {
+      // Input fields are already random
+      randDone = true;
+    } else if (!randDone) {
+      apply(stage, fset, [](const SaberBlockBase_ & block, atlas::FieldSet & fs)
+                         {block.randomize(fs);});
+      randDone = true;
+    } else {
+      apply(stage, fset, [](const SaberBlockBase_ & block, atlas::FieldSet & fs)
+                         {block.multiply(fs);});
+    }
+  }
+
+  // Copy results back into the original fields
+  restore(originals, fset);
+
+  oops::Log::trace() << classname() << "::randomize done" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename MODEL>
+void SaberBlockChain<MODEL>::multiply(atlas::FieldSet & fset) const {
+  oops::Log::trace() << classname() << "::multiply starting" << std::endl;
+
+  // Original fields
+  const std::vector<atlas::Field> originals(fset.begin(), fset.end());
+
+  // K_1^T K_2^T .. K_N^T
+  for (const Stage & stage : adjoint_) {
+    apply(stage, fset, [](const SaberBlockBase_ & block, atlas::FieldSet & fs)
+                       {block.multiplyAD(fs);});
+  }
+
+  // Central block multiplication
+  if (central_) {
+    apply(*central_, fset, [](const SaberBlockBase_ & block, atlas::FieldSet & fs)
+                           {block.multiply(fs);});
+  }
+
+  // K_N K_N-1 ... K_1
+  for (const Stage & stage : forward_) {
+    if (!stage.block->isIdentity()) {
+      apply(stage, fset, [](const SaberBlockBase_ & block, atlas::FieldSet & fs)
+                         {block.multiply(fs);});
+    }
+  }
+
+  // Copy results back into the original fields
+  restore(originals, fset);
+
+  oops::Log::trace() << classname() << "::multiply done" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename MODEL>
+void SaberBlockChain<MODEL>::report(std::ostream & os) const {
+  std::vector<const Stage *> stages;
+  for (const Stage & stage : adjoint_) stages.push_back(&stage);
+  if (central_) stages.push_back(central_.get());
+  for (const Stage & stage : forward_) stages.push_back(&stage);
+
+  std::size_t poolBytes(0);
+  for (const auto & pool : pools_) poolBytes += pool->bytes();
+
+  bool header(true);
+  for (const Stage * stage : stages) {
+    if (stage->calls > 0) {
+      if (header) {
+        os << "SABER block chain statistics (calls, total time, mean time, fields size):"
+           << std::endl;
+        header = false;
+      }
+      os << "  " << std::left << std::setw(40) << stage->label << std::right
+         << std::setw(8) << stage->calls
+         << std::setw(12) << std::fixed << std::setprecision(3) << stage->seconds << " s"
+         << std::setw(12) << 1.0e3*stage->seconds/static_cast<double>(stage->calls) << " ms"
+         << std::setw(12) << std::setprecision(1)
+         << static_cast<double>(stage->bytes)/1048576.0 << " MiB" << std::endl;
+    }
+  }
+  if (!header) {
+    os << "  Pooled work fields: " << std::fixed << std::setprecision(1)
+       << static_cast<double>(poolBytes)/1048576.0 << " MiB" << std::endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename MODEL>
+template <typename OP>
+void SaberBlockChain<MODEL>::apply(const Stage & stage,
+                                   atlas::FieldSet & fset,
+                                   const OP & op) const {
+  eckit::Timer timer;
+  timer.start();
+  op(*stage.block, fset);
+  stage.calls++;
+  stage.seconds += timer.elapsed();
+  stage.bytes = std::max(stage.bytes, FieldSetPool::bytes(fset));
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename MODEL>
+void SaberBlockChain<MODEL>::restore(const std::vector<atlas::Field> & originals,
+                                     atlas::FieldSet & fset) const {
+  // Nothing to restore
+  if (originals.empty()) return;
+
+  bool replaced(fset.size() != static_cast<atlas::idx_t>(originals.size()));
+  for (const atlas::Field & original : originals) {
+    if (!fset.has_field(original.name())) {
+      ABORT("SaberBlockChain: field " + original.name() + " missing at the end of the chain");
+    }
+    const atlas::Field field = fset[original.name()];
+
+    // Same field, no copy
+    if (field.get() == original.get()) continue;
+    replaced = true;
+
+    // Copy values
+    if (field.shape(0) != original.shape(0) || field.levels() != original.levels()) {
+      ABORT("SaberBlockChain: wrong shape for field " + original.name());
+    }
+    atlas::Field target(original);
+    auto src = atlas::array::make_view<const double, 2>(field);
+    auto dst = atlas::array::make_view<double, 2>(target);
+    for (atlas::idx_t jnode = 0; jnode < field.shape(0); ++jnode) {
+      for (atlas::idx_t jlevel = 0; jlevel < field.levels(); ++jlevel) {
+        dst(jnode, jlevel) = src(jnode, jlevel);
+      }
+    }
+  }
+
+  // Put the original fields back
+  if (replaced) {
+    fset = atlas::FieldSet();
+    for (const atlas::Field & original : originals) {
+      fset.add(original);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+
+}  // namespace saber
+
+#endif  // SABER_OOPS_SABERBLOCKCHAIN_H_
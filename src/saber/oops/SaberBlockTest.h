@@ -13,15 +13,20 @@
 #include <vector>
 #include <boost/ptr_container/ptr_vector.hpp>
 
+#include "eckit/config/LocalConfiguration.h"
+
 #include "oops/base/Increment.h"
+#include "oops/base/ModelSpaceCovarianceBase.h"
 #include "oops/base/State.h"
 #include "oops/base/Variables.h"
 #include "oops/mpi/mpi.h"
 #include "oops/runs/Application.h"
 #include "oops/util/Logger.h"
+#include "oops/util/parameters/OptionalParameter.h"
 #include "oops/util/parameters/Parameter.h"
 #include "oops/util/parameters/RequiredParameter.h"
 
+#include "saber/oops/ErrorCovariance.h"
 #include "saber/oops/SaberBlockBase.h"
 #include "saber/oops/SaberBlockParametersBase.h"
 
@@ -62,8 +67,18 @@ template <typename MODEL> class SaberBlockTestParameters
   /// Adjoint test tolerance
   oops::Parameter<double> adjointTolerance{"adjoint test tolerance", 1.0e-12, this};
 
+  /// Test the adjoint of the central block (multiplyAD) on top of its symmetry
+  oops::Parameter<bool> centralAdjointTest{"central block adjoint test", false, this};
+
   /// Inverse test tolerance
   oops::Parameter<double> inverseTolerance{"inverse test tolerance", 1.0e-12, this};
+
+  /// Central block inverse solver, tested on the full covariance if present
+  oops::OptionalParameter<InverseSolverParameters> inverseSolver{"inverse solver", this};
+
+  /// Covariance inverse test tolerance (relative residual of the inverse solver)
+  oops::Parameter<double> covarianceInverseTolerance{"covariance inverse test tolerance", 1.0e-3,
+    this};
 };
 
 // -----------------------------------------------------------------------------
@@ -155,6 +170,32 @@ template <typename MODEL> class SaberBlockTest : public oops::Application {
       ASSERT(0.5*abs(dp1-dp2)/(dp1+dp2) < params.adjointTolerance.value());
     }
 
+    // Adjoint test for central block multiplyAD
+    if (saberCentralBlock_ && params.centralAdjointTest.value()) {
+      // Generate random increments and save them
+      dx1.random();
+      dx2.random();
+      dx1save = dx1;
+      dx2save = dx2;
+
+      // Apply central block and its adjoint
+      saberCentralBlock_->multiply(dx1.fieldSet());
+      saberCentralBlock_->multiplyAD(dx2.fieldSet());
+
+      // ATLAS fieldset to Increment_
+      dx1.synchronizeFields();
+      dx2.synchronizeFields();
+
+      // Compute adjoint test
+      const double dp1 = dx1.dot_product_with(dx2save);
+      const double dp2 = dx2.dot_product_with(dx1save);
+
+      oops::Log::test() << "Adjoint test for central block " << saberCentralBlock_->name() <<
+                           ": y^t (Ax) = " << dp1 <<
+                           "; x^t (A^t y) = " << dp2 << std::endl;
+      ASSERT(0.5*abs(dp1-dp2)/(dp1+dp2) < params.adjointTolerance.value());
+    }
+
     // Adjoint test for other blocks
     for (icst_ it = saberBlocks_.begin(); it != saberBlocks_.end(); ++it) {
       // Generate random increments and save them
@@ -239,6 +280,35 @@ template <typename MODEL> class SaberBlockTest : public oops::Application {
       }
     }
 
+    // Inverse test for the full covariance
+    if (params.inverseSolver.value() != boost::none) {
+      // Setup covariance with the same blocks
+      eckit::LocalConfiguration covarConf;
+      covarConf.set("covariance model", "SABER");
+      covarConf.set("saber blocks", fullConfig.getSubConfigurations("saber blocks"));
+      covarConf.set("inverse solver", fullConfig.getSubConfiguration("inverse solver"));
+      ErrorCovarianceParameters<MODEL> covarParams;
+      covarParams.deserialize(covarConf);
+      const ErrorCovariance<MODEL> covar(geom, vars, covarParams, xx, xx);
+      const oops::ModelSpaceCovarianceBase<MODEL> & Bmat = covar;
+
+      // Right-hand side in the range of B
+      dx1.random();
+      Bmat.multiply(dx1, dx1save);
+
+      // Apply inverse and covariance again
+      Bmat.inverseMultiply(dx1save, dx2);
+      Bmat.multiply(dx2, dx1);
+
+      // Compute inverse test
+      dx1 -= dx1save;
+      const double dp1 = dx1.norm()/dx1save.norm();
+      oops::Log::test() << "Inverse test for covariance ("
+        << params.inverseSolver.value()->solver.value() << ")" << std::endl;
+      oops::Log::info() << "Covariance inverse relative residual: " << dp1 << std::endl;
+      ASSERT(dp1 < params.covarianceInverseTolerance.value());
+    }
+
     return 0;
   }
 
@@ -63,6 +63,8 @@ class SPCTRL_COV : public SaberBlockBase<MODEL> {
   void multiplyAD(atlas::FieldSet &) const override;
   void inverseMultiplyAD(atlas::FieldSet &) const override;
 
+  bool hasInverse() const override {return false;}
+
  private:
   void print(std::ostream &) const override;
   std::unique_ptr<SpectralB_> spectralb_;
@@ -0,0 +1,187 @@
+/*
+ * (C) Crown Copyright 2022 Met Office
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include "saber/spectralb/SpectralVerticalKernel.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atlas/array/MakeView.h"
+#include "atlas/parallel/omp/omp.h"
+
+#include "oops/util/Logger.h"
+
+#if SABER_ENABLE_BLAS
+extern "C" {
+  void dgemm_(const char * transa, const char * transb,
+              const int * m, const int * n, const int * k,
+              const double * alpha, const double * a, const int * lda,
+              const double * b, const int * ldb,
+              const double * beta, double * c, const int * ldc);
+}
+#endif
+
+namespace saber {
+namespace spectralb {
+
+// -----------------------------------------------------------------------------
+
+SpectralVerticalKernel::SpectralVerticalKernel(
+  const atlas::FieldSet & spectralVerticalCovariances,
+  const atlas::functionspace::Spectral & specFS,
+  const atlas::FieldSet & specFields) :
+  fieldNames_(specFields.field_names()),
+  N_(specFS.truncation()),
+  nCoef_(0)
+{
+  oops::Log::trace() << "SpectralVerticalKernel::SpectralVerticalKernel starting" << std::endl;
+
+  for (const std::string & fieldName : fieldNames_) {
+    fieldLevels_.push_back(specFields[fieldName].levels());
+  }
+
+  const auto zonal_wavenumbers = specFS.zonal_wavenumbers();
+  const atlas::idx_t nb_zonal_wavenumbers = zonal_wavenumbers.size();
+
+  // count the local spectral coefficients for each total wavenumber
+  std::vector<int> nCoefByN(static_cast<std::size_t>(N_ + 1), 0);
+  for (atlas::idx_t jm = 0; jm < nb_zonal_wavenumbers; ++jm) {
+    const int m1 = zonal_wavenumbers(jm);
+    for (int n1 = m1; n1 <= N_; ++n1) {
+      nCoefByN[static_cast<std::size_t>(n1)] += 2;
+    }
+  }
+
+  // offsets of each total wavenumber in the reordered coefficients
+  nOffset_.resize(static_cast<std::size_t>(N_ + 2), 0);
+  for (int n1 = 0; n1 <= N_; ++n1) {
+    nOffset_[static_cast<std::size_t>(n1 + 1)] =
+      nOffset_[static_cast<std::size_t>(n1)] + nCoefByN[static_cast<std::size_t>(n1)];
+  }
+  nCoef_ = nOffset_[static_cast<std::size_t>(N_ + 1)];
+
+  // position of each spectral coefficient (in the atlas ordering) in the reordered coefficients
+  coefToOrdered_.resize(static_cast<std::size_t>(nCoef_));
+  std::vector<int> next(nOffset_.begin(), nOffset_.end() - 1);
+  int i = 0;
+  for (atlas::idx_t jm = 0; jm < nb_zonal_wavenumbers; ++jm) {
+    const int m1 = zonal_wavenumbers(jm);
+    for (int n1 = m1; n1 <= N_; ++n1) {
+      for (std::size_t img = 0; img < 2; ++img) {
+        coefToOrdered_[static_cast<std::size_t>(i)] = next[static_cast<std::size_t>(n1)]++;
+        ++i;
+      }
+    }
+  }
+
+  // normalised matrices for each field and total wavenumber
+  std::size_t maxLevels(0);
+  for (std::size_t f = 0; f < fieldNames_.size(); ++f) {
+    const int levels = fieldLevels_[f];
+    maxLevels = std::max(maxLevels, static_cast<std::size_t>(levels));
+    auto vertCovView =
+      atlas::array::make_view<const double, 3>(spectralVerticalCovariances[fieldNames_[f]]);
+    const double nBins =
+      static_cast<double>(spectralVerticalCovariances[fieldNames_[f]].shape(0));
+
+    std::vector<double> matrices(static_cast<std::size_t>((N_ + 1) * levels * levels));
+    for (int n1 = 0; n1 <= N_; ++n1) {
+      const double norm = static_cast<double>(2 * n1 + 1) * nBins;
+      double * mat = matrices.data() + static_cast<std::size_t>(n1 * levels * levels);
+      for (int c = 0; c < levels; ++c) {
+        for (int r = 0; r < levels; ++r) {
+          mat[r + c * levels] = vertCovView(n1, r, c) / norm;
+        }
+      }
+    }
+    matrices_.push_back(std::move(matrices));
+  }
+
+  // work arrays for the reordered coefficients
+  workIn_.resize(static_cast<std::size_t>(nCoef_) * maxLevels);
+  workOut_.resize(static_cast<std::size_t>(nCoef_) * maxLevels);
+
+  oops::Log::trace() << "SpectralVerticalKernel::SpectralVerticalKernel done" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+
+void SpectralVerticalKernel::apply(atlas::FieldSet & specFields) const {
+  oops::Log::trace() << "SpectralVerticalKernel::apply starting" << std::endl;
+
+  for (std::size_t f = 0; f < fieldNames_.size(); ++f) {
+    const int levels = fieldLevels_[f];
+    auto spfView = atlas::array::make_view<double, 2>(specFields[fieldNames_[f]]);
+    const double * matrices = matrices_[f].data();
+    double * workIn = workIn_.data();
+    double * workOut = workOut_.data();
+
+    // gather the coefficients, ordered by total wavenumber (levels are contiguous)
+    atlas_omp_parallel_for(int i = 0; i < nCoef_; ++i) {
+      double * col = workIn + static_cast<std::size_t>(coefToOrdered_[i] * levels);
+      for (int jl = 0; jl < levels; ++jl) {
+        col[jl] = spfView(i, jl);
+      }
+    }
+
+    // apply the matrices, one batch of coefficients per total wavenumber
+#if SABER_ENABLE_BLAS
+    // sequential loop over total wavenumbers, the BLAS library can be threaded
+    const char trans = 'N';
+    const double one = 1.0;
+    const double zero = 0.0;
+    for (int n1 = 0; n1 <= N_; ++n1) {
+      const int nCol = nOffset_[n1 + 1] - nOffset_[n1];
+      if (nCol > 0) {
+        const double * mat = matrices + static_cast<std::size_t>(n1 * levels * levels);
+        const double * in = workIn + static_cast<std::size_t>(nOffset_[n1] * levels);
+        double * out = workOut + static_cast<std::size_t>(nOffset_[n1] * levels);
+        dgemm_(&trans, &trans, &levels, &nCol, &levels, &one, mat, &levels,
+               in, &levels, &zero, out, &levels);
+      }
+    }
+#else
+    atlas_omp_parallel_for(int n1 = 0; n1 <= N_; ++n1) {
+      const int nCol = nOffset_[n1 + 1] - nOffset_[n1];
+      if (nCol > 0) {
+        const double * mat = matrices + static_cast<std::size_t>(n1 * levels * levels);
+        const double * in = workIn + static_cast<std::size_t>(nOffset_[n1] * levels);
+        double * out = workOut + static_cast<std::size_t>(nOffset_[n1] * levels);
+        for (int k = 0; k < nCol; ++k) {
+          double * outCol = out + static_cast<std::size_t>(k * levels);
+          const double * inCol = in + static_cast<std::size_t>(k * levels);
+          std::fill(outCol, outCol + levels, 0.0);
+          for (int c = 0; c < levels; ++c) {
+            const double * matCol = mat + static_cast<std::size_t>(c * levels);
+            const double val = inCol[c];
+            for (int r = 0; r < levels; ++r) {
+              outCol[r] += matCol[r] * val;
+            }
+          }
+        }
+      }
+    }
+#endif
+
+    // scatter the coefficients back
+    atlas_omp_parallel_for(int i = 0; i < nCoef_; ++i) {
+      const double * col = workOut + static_cast<std::size_t>(coefToOrdered_[i] * levels);
+      for (int jl = 0; jl < levels; ++jl) {
+        spfView(i, jl) = col[jl];
+      }
+    }
+  }
+
+  oops::Log::trace() << "SpectralVerticalKernel::apply done" << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+
+}  // namespace spectralb
+}  // namespace saber
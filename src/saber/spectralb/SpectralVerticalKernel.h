@@ -0,0 +1,62 @@
+/*
+ * (C) Crown Copyright 2022 Met Office
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef SABER_SPECTRALB_SPECTRALVERTICALKERNEL_H_
+#define SABER_SPECTRALB_SPECTRALVERTICALKERNEL_H_
+
+#include <string>
+#include <vector>
+
+#include "atlas/field/Field.h"
+#include "atlas/field/FieldSet.h"
+#include "atlas/functionspace/Spectral.h"
+
+namespace saber {
+namespace spectralb {
+
+// -----------------------------------------------------------------------------
+
+/// \details SpectralVerticalKernel applies the spectral vertical covariances (or correlations)
+///          to a set of spectral fields. For each field and total wavenumber n, the
+///          normalised level x level matrix is stored contiguously (column-major), and it is
+///          applied to all the spectral coefficients (m, real/imaginary) of this total
+///          wavenumber at once, with a DGEMM call when BLAS is available
+///          (SABER_ENABLE_BLAS).
+class SpectralVerticalKernel {
+ public:
+  SpectralVerticalKernel(const atlas::FieldSet &,
+                         const atlas::functionspace::Spectral &,
+                         const atlas::FieldSet &);
+
+  /// \details apply() multiplies in place the spectral coefficients of each field
+  ///          by the vertical covariance matrix of their total wavenumber
+  void apply(atlas::FieldSet &) const;
+
+ private:
+  std::vector<std::string> fieldNames_;
+  std::vector<int> fieldLevels_;
+  // truncation
+  int N_;
+  // number of local spectral coefficients
+  int nCoef_;
+  // offsets of each total wavenumber in the reordered coefficients
+  std::vector<int> nOffset_;
+  // position of each local spectral coefficient in the reordered coefficients
+  std::vector<int> coefToOrdered_;
+  // normalised vertical matrices (column-major) for each field and total wavenumber
+  std::vector<std::vector<double>> matrices_;
+  // work arrays
+  mutable std::vector<double> workIn_;
+  mutable std::vector<double> workOut_;
+};
+
+// -----------------------------------------------------------------------------
+
+}  // namespace spectralb
+}  // namespace saber
+
+#endif  // SABER_SPECTRALB_SPECTRALVERTICALKERNEL_H_
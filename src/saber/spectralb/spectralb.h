@@ -32,6 +32,7 @@
 #include "saber/interpolation/AtlasInterpWrapper.h"
 #include "saber/spectralb/CovarianceStatistics.h"
 #include "saber/spectralb/spectralbParameters.h"
+#include "saber/spectralb/SpectralVerticalKernel.h"
 
 using atlas::grid::detail::partitioner::TransPartitioner;
 
@@ -77,6 +78,41 @@ std::shared_ptr<atlas::FieldSet> allocateGaussFieldset(
 
 // -----------------------------------------------------------------------------
 
+atlas::functionspace::Spectral
+    createSpectralFunctionSpace(const atlas::StructuredGrid & gaussGrid,
+                                const atlas::FieldSet & fset) {
+  oops::Log::trace() << "inside createSpectralFunctionSpace" << std::endl;
+  // assuming that all fields in fset have the same number of levels
+  return atlas::functionspace::Spectral(
+    2*atlas::GaussianGrid(gaussGrid).N()-1,
+    atlas::option::levels(fset[0].levels()));
+}
+
+std::shared_ptr<atlas::FieldSet> allocateSpectralFieldset(
+    const atlas::functionspace::Spectral & specFunctionSpace,
+    const std::shared_ptr<const atlas::FieldSet> & gaussFieldSet) {
+
+  oops::Log::trace() << "allocateSpectralFieldset starting" << std::endl;
+
+  // create spectral FieldSet, used as work space for the spectral transforms
+  auto specFieldSet = std::make_shared<atlas::FieldSet>();
+  std::vector<std::string> fieldNames = (*gaussFieldSet).field_names();
+
+  for (std::size_t i = 0; i < fieldNames.size(); ++i) {
+    atlas::Field specField =
+      specFunctionSpace.createField<double>(
+        atlas::option::name(fieldNames[i]) |
+        atlas::option::levels((*gaussFieldSet)[fieldNames[i]].levels()));
+
+    (*specFieldSet).add(specField);
+  }
+
+  oops::Log::trace() << "allocateSpectralFieldset done" << std::endl;
+  return specFieldSet;
+}
+
+// -----------------------------------------------------------------------------
+
 template<typename MODEL>
 atlas::Grid createOutputGrid(const spectralbParameters<MODEL> & params) {
   std::string gridName((params.outputGridUid.value() != boost::none ?
@@ -135,15 +171,18 @@ class SpectralB {
   atlas::StructuredGrid gaussGrid_;
   atlas::functionspace::StructuredColumns gaussFunctionSpace_;
   std::shared_ptr<atlas::FieldSet> gaussFieldSet_;
+  atlas::functionspace::Spectral specFunctionSpace_;
+  atlas::trans::Trans trans_;
+  std::shared_ptr<atlas::FieldSet> specFieldSet_;
   saber::interpolation::AtlasInterpWrapper interp_;
   bool variance_opt_;
   std::unique_ptr<const CovStat_ErrorCov<MODEL>> cs_;
+  SpectralVerticalKernel kernel_;
 
   // this method applies the adjoint of the inverse transform
   // then does a convolution with the spectral vertical covariances
-  void applySpectralB(const atlas::FieldSet &,
-                      const atlas::functionspace::Spectral &,
-                      const atlas::trans::Trans &,
+  void applySpectralB(const atlas::trans::Trans &,
+                      atlas::FieldSet &,
                       atlas::FieldSet &) const;
 };
 
@@ -159,10 +198,16 @@ SpectralB<MODEL>::SpectralB(const Geometry_ & resol,
   gaussGrid_(params.gaussGridUid),
   gaussFunctionSpace_(detail::createGaussFunctionSpace(gaussGrid_)),
   gaussFieldSet_(detail::allocateGaussFieldset(gaussFunctionSpace_, gaussNames_, modelFieldSet_)),
+  specFunctionSpace_(detail::createSpectralFunctionSpace(gaussGrid_, *modelFieldSet_)),
+  trans_(gaussFunctionSpace_, specFunctionSpace_),
+  specFieldSet_(detail::allocateSpectralFieldset(specFunctionSpace_, gaussFieldSet_)),
   interp_(atlas::grid::Partitioner(new TransPartitioner()), gaussFunctionSpace_,
     detail::createOutputGrid(params), detail::createOutputFunctionSpace(*modelFieldSet_)),
   variance_opt_(detail::createVarianceOpt(params)),
-  cs_(std::make_unique<const CovStat_ErrorCov<MODEL>>(resol, vars, params))
+  cs_(std::make_unique<const CovStat_ErrorCov<MODEL>>(resol, vars, params)),
+  kernel_(variance_opt_ ? cs_->getSpectralVerticalCovariances() :
+                          cs_->getSpectralVerticalCorrelations(),
+          specFunctionSpace_, *specFieldSet_)
 {
   oops::Log::trace() << "SpectralB<MODEL>::SpectralB done" << std::endl;
 }
@@ -188,21 +233,12 @@ template<typename MODEL>
 void SpectralB<MODEL>::multiply_InterpAndCov(atlas::FieldSet & modelGridFieldSet) const {
   oops::Log::trace() << "SpectralB<MODEL> multiply_InterpAndCov start" << std::endl;
 
-  auto N = atlas::GaussianGrid(gaussGrid_).N();
-
-  // assuming that all fields in modelGridFieldSet have the same number of levels
-  atlas::functionspace::Spectral specFS(2*N-1,
-                                        atlas::option::levels(modelGridFieldSet[0].levels()));
-  atlas::trans::Trans transIFS(gaussFunctionSpace_, specFS);
-
+  // the spectral function space, the transform and the work FieldSets
+  // are set up once in the constructor
   interp_.executeAdjoint(*gaussFieldSet_, modelGridFieldSet);
 
-  // Spectral B
-  if (variance_opt_) {
-    applySpectralB(cs_->getSpectralVerticalCovariances(), specFS, transIFS, *gaussFieldSet_);
-  } else {
-    applySpectralB(cs_->getSpectralVerticalCorrelations(), specFS, transIFS, *gaussFieldSet_);
-  }
+  // Spectral B (covariances or correlations are selected in the constructor)
+  applySpectralB(trans_, *specFieldSet_, *gaussFieldSet_);
 
   gaussFieldSet_->haloExchange();
 
@@ -272,9 +308,8 @@ atlas::FieldSet SpectralB<MODEL>::createFieldsSpace(const Geometry_ & geom,
 
 template<typename MODEL>
 void SpectralB<MODEL>::applySpectralB(
-    const atlas::FieldSet & spectralVerticalCovariances,
-    const atlas::functionspace::Spectral & specFS,
     const atlas::trans::Trans & transIFS,
+    atlas::FieldSet & specFields,
     atlas::FieldSet & gaussFields) const {
   // the spectral B for each active variable is defined in 3 main steps
   // 1) the adjoint of the inverse spectral transform
@@ -284,58 +319,9 @@ void SpectralB<MODEL>::applySpectralB(
 
   oops::Log::trace() << "SpectralB<MODEL>::applySpectralB start" << std::endl;
 
-  std::vector<std::string> fieldNames = gaussFields.field_names();
-
-  idx_t N = specFS.truncation();
-
-  std::vector<std::string> vertCovNames = spectralVerticalCovariances.field_names();
-
-  atlas::FieldSet specFields;
-
-  for (std::size_t f = 0; f < static_cast<std::size_t>(fieldNames.size()); f++) {
-    atlas::Field specField =
-      specFS.createField<double>(atlas::option::name(fieldNames[f]) |
-                                 atlas::option::levels(gaussFields[fieldNames[f]].levels()));
-    specFields.add(specField);
-  }
-
   transIFS.invtrans_adj(gaussFields, specFields);
 
-  const auto zonal_wavenumbers = specFS.zonal_wavenumbers();
-  const int nb_zonal_wavenumbers = zonal_wavenumbers.size();
-
-  int i;
-  for (idx_t f = 0; f < gaussFields.size(); f++) {
-    int levels(gaussFields[fieldNames[f]].levels());
-    auto vertCovView = make_view<const double, 3>(spectralVerticalCovariances[fieldNames[f]]);
-    auto spfView = make_view<double, 2>(specFields[fieldNames[f]]);
-
-    i = 0;
-    std::vector<double> col(levels), col2(levels);
-    double norm;
-    for (int jm = 0; jm < nb_zonal_wavenumbers; ++jm) {
-      const int m1 = zonal_wavenumbers(jm);
-      for (std::size_t n1 = m1; n1 <= static_cast<std::size_t>(N); ++n1) {
-        for (std::size_t img = 0; img < 2; ++img) {
-          for (idx_t jl = 0; jl < levels; ++jl) {
-            col[static_cast<std::size_t>(jl)] = spfView(i, jl);
-          }
-          norm = static_cast<double>((2 * n1 + 1) *
-                                     spectralVerticalCovariances[fieldNames[f]].shape(0));
-          for (idx_t r = 0; r < levels; ++r) {
-            col2[static_cast<std::size_t>(r)] = 0;
-            for (idx_t c = 0; c < levels; ++c) {
-              col2[static_cast<std::size_t>(r)] += vertCovView(n1, r, c) * col[c] / norm;
-            }
-          }
-          for  (idx_t jl = 0; jl < levels; ++jl) {
-            spfView(i, jl) = col2[static_cast<std::size_t>(jl)];
-          }
-          ++i;
-        }
-      }
-    }
-  }
+  kernel_.apply(specFields);
 
   transIFS.invtrans(specFields, gaussFields);
 
@@ -31,6 +31,7 @@
 
 #include "saber/spectralb/CovarianceStatistics.h"
 #include "saber/spectralb/spectralbParameters.h"
+#include "saber/spectralb/SpectralVerticalKernel.h"
 
 using atlas::grid::detail::partitioner::TransPartitioner;
 
@@ -49,6 +50,38 @@ atlas::functionspace::StructuredColumns
 
 // -----------------------------------------------------------------------------
 
+atlas::functionspace::Spectral
+    createSpectralFunctionSpace(const atlas::StructuredGrid & gaussGrid,
+                                const std::vector<size_t> & varSizes) {
+  oops::Log::trace() << "inside createSpectralFunctionSpace" << std::endl;
+  // assuming that all fields have the same number of levels
+  return atlas::functionspace::Spectral(
+    2*atlas::GaussianGrid(gaussGrid).N()-1,
+    atlas::option::levels(varSizes[0]));
+}
+
+std::shared_ptr<atlas::FieldSet> allocateSpectralFieldset(
+    const atlas::functionspace::Spectral & specFunctionSpace,
+    const std::vector<std::string> & vars,
+    const std::vector<size_t> & varSizes) {
+  oops::Log::trace() << "allocateSpectralFieldset starting" << std::endl;
+
+  // create spectral FieldSet, used as work space for the spectral transforms
+  auto specFieldSet = std::make_shared<atlas::FieldSet>();
+
+  for (std::size_t i = 0; i < vars.size(); ++i) {
+    atlas::Field specField =
+      specFunctionSpace.createField<double>(atlas::option::name(vars[i]) |
+                                            atlas::option::levels(varSizes[i]));
+    (*specFieldSet).add(specField);
+  }
+
+  oops::Log::trace() << "allocateSpectralFieldset done" << std::endl;
+  return specFieldSet;
+}
+
+// -----------------------------------------------------------------------------
+
 template<typename MODEL>
 bool createVarianceOpt(const spectralbParameters<MODEL> & params) {
   return (params.varianceOpt.value() != boost::none ?
@@ -90,14 +123,17 @@ class SpectralBNoInterp {
   atlas::StructuredGrid gaussGrid_;
   atlas::functionspace::StructuredColumns gaussFunctionSpace_;
 //  atlas::FieldSet  gaussFieldSet_;
+  atlas::functionspace::Spectral specFunctionSpace_;
+  atlas::trans::Trans trans_;
+  std::shared_ptr<atlas::FieldSet> specFieldSet_;
   bool variance_opt_;
   std::unique_ptr<const CovStat_ErrorCov<MODEL>> cs_;
+  SpectralVerticalKernel kernel_;
 
   // this method applies the adjoint of the inverse transform
   // then does a convolution with the spectral vertical covariances
-  void applySpectralBNoInterp(const atlas::FieldSet &,
-                              const atlas::functionspace::Spectral &,
-                              const atlas::trans::Trans &,
+  void applySpectralBNoInterp(const atlas::trans::Trans &,
+                              atlas::FieldSet &,
                               atlas::FieldSet &) const;
 };
 
@@ -116,8 +152,14 @@ SpectralBNoInterp<MODEL>::SpectralBNoInterp(const Geometry_ & resol,
   varSizes_(resol.variableSizes(vars)),
   gaussGrid_(params.gaussGridUid),
   gaussFunctionSpace_(detailnointerp::createGaussFunctionSpace(gaussGrid_)),
+  specFunctionSpace_(detailnointerp::createSpectralFunctionSpace(gaussGrid_, varSizes_)),
+  trans_(gaussFunctionSpace_, specFunctionSpace_),
+  specFieldSet_(detailnointerp::allocateSpectralFieldset(specFunctionSpace_, vars_, varSizes_)),
   variance_opt_(detailnointerp::createVarianceOpt(params)),
-  cs_(std::make_unique<const CovStat_ErrorCov<MODEL>>(resol, vars, params))
+  cs_(std::make_unique<const CovStat_ErrorCov<MODEL>>(resol, vars, params)),
+  kernel_(variance_opt_ ? cs_->getSpectralVerticalCovariances() :
+                          cs_->getSpectralVerticalCorrelations(),
+          specFunctionSpace_, *specFieldSet_)
 {
   oops::Log::trace() << "SpectralBNoInterp<MODEL>::SpectralBNoInterp done" << std::endl;
 }
@@ -143,23 +185,8 @@ template<typename MODEL>
 void SpectralBNoInterp<MODEL>::multiply(atlas::FieldSet & gaussFieldSet) const {
   oops::Log::trace() << "SpectralBNoInterp<MODEL> multiply start" << std::endl;
 
-  auto N = atlas::GaussianGrid(gaussGrid_).N();
-
-  // assuming that all fields in gaussFieldSet have the same number of levels
-  atlas::functionspace::Spectral specFS(
-    2*N-1,
-    atlas::option::levels(gaussFieldSet[0].levels()));
-  atlas::trans::Trans transIFS(gaussFunctionSpace_, specFS);
-
-
-  // Spectral B
-  if (variance_opt_) {
-    applySpectralBNoInterp(
-      cs_->getSpectralVerticalCovariances(), specFS, transIFS, gaussFieldSet);
-  } else {
-    applySpectralBNoInterp(
-      cs_->getSpectralVerticalCorrelations(), specFS, transIFS, gaussFieldSet);
-  }
+  // Spectral B (covariances or correlations are selected in the constructor)
+  applySpectralBNoInterp(trans_, *specFieldSet_, gaussFieldSet);
 
   gaussFieldSet->haloExchange();
 
@@ -199,9 +226,8 @@ void SpectralBNoInterp<MODEL>::print(std::ostream & os) const {
 
 template<typename MODEL>
 void SpectralBNoInterp<MODEL>::applySpectralBNoInterp(
-    const atlas::FieldSet & spectralVerticalCovariances,
-    const atlas::functionspace::Spectral & specFS,
     const atlas::trans::Trans & transIFS,
+    atlas::FieldSet & specFields,
     atlas::FieldSet & gaussFields) const {
   // the spectral B for each active variable is defined in 3 main steps
   // 1) the adjoint of the inverse spectral transform
@@ -211,60 +237,9 @@ void SpectralBNoInterp<MODEL>::applySpectralBNoInterp(
 
   oops::Log::trace() << "SpectralBNoInterp<MODEL>::applySpectralBNoInterp start" << std::endl;
 
-  std::vector<std::string> fieldNames = gaussFields.field_names();
-
-  idx_t N = specFS.truncation();
-
-  std::vector<std::string> vertCovNames = spectralVerticalCovariances.field_names();
-
-  atlas::FieldSet specFields;
-
-  for (std::size_t f = 0; f < static_cast<std::size_t>(fieldNames.size()); f++) {
-    atlas::Field specField =
-      specFS.createField<double>(atlas::option::name(fieldNames[f]) |
-                                 atlas::option::levels(gaussFields[fieldNames[f]].levels()));
-    specFields.add(specField);
-  }
-
   transIFS.invtrans_adj(gaussFields, specFields);
 
-  const auto zonal_wavenumbers = specFS.zonal_wavenumbers();
-  const idx_t nb_zonal_wavenumbers = zonal_wavenumbers.size();
-
-  idx_t i;
-  for (idx_t f = 0; f < gaussFields.size(); f++) {
-    idx_t levels(gaussFields[fieldNames[f]].levels());
-    auto vertCovView = make_view<const double, 3>(spectralVerticalCovariances[fieldNames[f]]);
-    auto spfView = make_view<double, 2>(specFields[fieldNames[f]]);
-
-    i = 0;
-    std::vector<double> col(levels), col2(levels);
-    double norm;
-    for (idx_t jm = 0; jm < nb_zonal_wavenumbers; ++jm) {
-      const idx_t m1 = zonal_wavenumbers(jm);
-      for (std::size_t n1 = m1; n1 <= static_cast<std::size_t>(N); ++n1) {
-        // note that img stands for imaginary component are the
-        // odd indices in the first index of the spectral fields.
-        for (std::size_t img = 0; img < 2; ++img) {
-          for (idx_t jl = 0; jl < levels; ++jl) {
-            col[static_cast<std::size_t>(jl)] = spfView(i, jl);
-          }
-          norm = static_cast<double>((2 * n1 + 1) *
-                                     spectralVerticalCovariances[fieldNames[f]].shape(0));
-          for (idx_t r = 0; r < levels; ++r) {
-            col2[static_cast<std::size_t>(r)] = 0;
-            for (idx_t c = 0; c < levels; ++c) {
-              col2[static_cast<std::size_t>(r)] += vertCovView(n1, r, c) * col[c] / norm;
-            }
-          }
-          for  (idx_t jl = 0; jl < levels; ++jl) {
-            spfView(i, jl) = col2[static_cast<std::size_t>(jl)];
-          }
-          ++i;
-        }
-      }
-    }
-  }
+  kernel_.apply(specFields);
 
   transIFS.invtrans(specFields, gaussFields);
 
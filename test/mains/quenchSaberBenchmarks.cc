@@ -0,0 +1,18 @@
+/*
+ * (C) Copyright 2022 UCAR.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include "oops/runs/Run.h"
+#include "quench/Traits.h"
+#include "saber/oops/instantiateSaberBlockFactory.h"
+#include "saber/oops/SaberBenchmarks.h"
+
+int main(int argc,  char ** argv) {
+  oops::Run run(argc, argv);
+  saber::instantiateSaberBlockFactory<quench::Traits>();
+  saber::SaberBenchmarks<quench::Traits> bench;
+  return run.execute(bench);
+}
@@ -32,6 +32,23 @@ if test "${test%%_*}" = "bump" ; then
       if [[ ! $2 =~ ^-?[0-9]+$ ]] && [[ ! $4 =~ ^-?[0-9]+$ ]] && [[ ! $3 =~ ^-?[0-9]+$ ]] ; then
          compare_type="specific"
       fi
+      # Arguments 2 and 3 are MPI-OpenMP pairs => exact comparison between two runs of the same test
+      if [[ $2 =~ ^[0-9]+-[0-9]+$ ]] && [[ $3 =~ ^[0-9]+-[0-9]+$ ]] ; then
+         compare_type="exact"
+      fi
+   fi
+   if test "$#" = 4 ; then
+      # Arguments 2 and 3 are MPI-OpenMP pairs and argument 4 is "tolerance" => comparison with tolerance between two runs
+      # of the same test (e.g. different numbers of MPI tasks)
+      if [[ $2 =~ ^[0-9]+-[0-9]+$ ]] && [[ $3 =~ ^[0-9]+-[0-9]+$ ]] && test "$4" = "tolerance" ; then
+         compare_type="tolerance"
+      fi
+      # Argument 2 is a test name, argument 3 is an MPI-OpenMP pair and argument 4 is a real number => specific
+      # comparison with this relative tolerance (in percent, for stochastic estimates)
+      if [[ ! $2 =~ ^[0-9]+-[0-9]+$ ]] && [[ $3 =~ ^[0-9]+-[0-9]+$ ]] && [[ $4 =~ ^[0-9.]+([eE][-+]?[0-9]+)?$ ]] ; then
+         compare_type="specific"
+         tolerance=$4
+      fi
    fi
 
    # Check comparison type
@@ -154,7 +171,7 @@ if test "${test%%_*}" = "bump" ; then
                done
 
                if test "${compare}" = "true"; then
-                  fileref=testdata/${test}/test_${mpiomp}_${suffix}.nc
+                  fileref=testdata/${testref}/test_${mpiomp}_${suffix}.nc
                   if [ -x "$(command -v nccmp)" ] ; then
                      # Compare files with NCCMP
                      echo -e "Command: nccmp -dfFmqS --threads=${nthreads} -T ${tolerance} ${file} ${fileref}"
@@ -173,6 +190,86 @@ if test "${test%%_*}" = "bump" ; then
          fi
       done
    fi
+
+   if test "${compare_type}" = "exact" ; then
+      # Exact comparison between two runs of the same test (e.g. different numbers of OpenMP threads)
+      mpiomp=$2
+      mpiompref=$3
+
+      # Check number of files
+      nfiles=`ls testdata/${test}/test_${mpiomp}_*.nc 2>/dev/null | wc -l`
+      if test "${nfiles}" = "0"; then
+         echo -e "\e[31mNo NetCDF file to check\e[0m" > /dev/stderr
+         status=10
+      fi
+
+      for file in `ls testdata/${test}/test_${mpiomp}_*.nc 2>/dev/null` ; do
+         # Get suffix
+         tmp=${file#testdata/${test}/test_${mpiomp}_}
+         suffix=${tmp%.nc}
+
+         if ! printf %s\\n "${suffix}" | grep -qF "distribution" ; then
+            fileref=testdata/${test}/test_${mpiompref}_${suffix}.nc
+            if [ -x "$(command -v nccmp)" ] ; then
+               # Compare files with NCCMP, without tolerance
+               echo -e "Command: nccmp -dfFmqS --threads=${nthreads} ${file} ${fileref}"
+               nccmp -dfFmqS --threads=${nthreads} ${file} ${fileref}
+               exit_code=$?
+               if test "${exit_code}" != "0" ; then
+                  echo -e "\e[31mTest failed (nccmp) checking: "${file#testdata/}"\e[0m" > /dev/stderr
+                  status=11
+               fi
+            else
+               echo -e "\e[31mCannot find command: nccmp\e[0m" > /dev/stderr
+               status=12
+            fi
+         fi
+      done
+   fi
+
+   if test "${compare_type}" = "tolerance" ; then
+      # Comparison with tolerance between two runs of the same test, MPI-dependent files excepted
+      mpiomp=$2
+      mpiompref=$3
+
+      # Check number of files
+      nfiles=`ls testdata/${test}/test_${mpiomp}_*.nc 2>/dev/null | wc -l`
+      if test "${nfiles}" = "0"; then
+         echo -e "\e[31mNo NetCDF file to check\e[0m" > /dev/stderr
+         status=13
+      fi
+
+      for file in `ls testdata/${test}/test_${mpiomp}_*.nc 2>/dev/null` ; do
+         # Get suffix
+         tmp=${file#testdata/${test}/test_${mpiomp}_}
+         suffix=${tmp%.nc}
+
+         # Check if this file should be compared
+         compare=true
+         for special in distribution ${mpi_dependent} ; do
+            if printf %s\\n "${suffix}" | grep -qF "${special}" ; then
+               compare=false
+            fi
+         done
+
+         if test "${compare}" = "true"; then
+            fileref=testdata/${test}/test_${mpiompref}_${suffix}.nc
+            if [ -x "$(command -v nccmp)" ] ; then
+               # Compare files with NCCMP
+               echo -e "Command: nccmp -dfFmqS --threads=${nthreads} -T ${tolerance} ${file} ${fileref}"
+               nccmp -dfFmqS --threads=${nthreads} -T ${tolerance} ${file} ${fileref}
+               exit_code=$?
+               if test "${exit_code}" != "0" ; then
+                  echo -e "\e[31mTest failed (nccmp) checking: "${file#testdata/}"\e[0m" > /dev/stderr
+                  status=14
+               fi
+            else
+               echo -e "\e[31mCannot find command: nccmp\e[0m" > /dev/stderr
+               status=15
+            fi
+         fi
+      done
+   fi
 fi
 
 # Exit
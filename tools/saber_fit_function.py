@@ -176,6 +176,8 @@ if run_horizontal and run_vertical:
    file.write("real(kind_real),parameter :: dnd = %.8f_kind_real\n" % (dnd))
    file.write("real(kind_real),parameter :: axis_invmin = %.8f_kind_real\n" % (axis_invmin))
    file.write("real(kind_real),parameter :: axis_invmax = %.8f_kind_real\n" % (axis_invmax))
+   file.write("integer,parameter :: fit_hor = 1\n")
+   file.write("integer,parameter :: fit_ver = 2\n")
    file.write("real(kind_real),parameter :: axis_inv(naxis_inv) = (/ &\n")
    for iaxis_inv in range(0, naxis_inv):
       if iaxis_inv != naxis_inv-1:
@@ -211,38 +213,101 @@ if run_horizontal and run_vertical:
       else:
          suffix = "/)"
       file.write(" & %.8f_kind_real" % (func_ver[ind]) + suffix + "\n")
+   file.write("real(kind_real),parameter :: func_tab(nnd,2) = reshape((/func_hor,func_ver/),(/nnd,2/))\n")
    file.write("\n")
+   file.write("interface fit_dir\n")
+   file.write("   module procedure gc99_fit_dir\n")
+   file.write("end interface\n")
    file.write("interface fit_func\n")
    file.write("   module procedure gc99_fit_func\n")
+   file.write("   module procedure gc99_fit_func_vec\n")
    file.write("end interface\n")
    file.write("interface fit_func_sqrt\n")
    file.write("   module procedure gc99_fit_func_sqrt\n")
+   file.write("   module procedure gc99_fit_func_sqrt_vec\n")
    file.write("end interface\n")
    file.write("\n")
    file.write("private\n")
    file.write("public :: naxis_inv,axis_inv,axis_invmin,axis_invmax\n")
    file.write("public :: func_inv_hor,func_inv_ver\n")
-   file.write("public :: fit_func,fit_func_sqrt\n")
+   file.write("public :: fit_hor,fit_ver\n")
+   file.write("public :: fit_dir,fit_func,fit_func_sqrt\n")
    file.write("\n")
    file.write("contains\n")
    file.write("\n")
    file.write("!----------------------------------------------------------------------\n")
-   file.write("! Function: gc99_fit_func\n")
-   file.write("!> Fit function\n")
+   file.write("! Function: gc99_fit_dir\n")
+   file.write("!> Fit function direction index\n")
    file.write("!----------------------------------------------------------------------\n")
-   file.write("function gc99_fit_func(mpl,dir,nd) result(value)\n")
+   file.write("function gc99_fit_dir(mpl,dir) result(idir)\n")
    file.write("\n")
    file.write("! Passed variables\n")
    file.write("type(mpl_type),intent(inout) :: mpl !< MPI data\n")
    file.write("character(len=*),intent(in) :: dir  !< Direction\n")
-   file.write("real(kind_real),intent(in) :: nd    !< Normalized distance\n")
+   file.write("\n")
+   file.write("! Returned variable\n")
+   file.write("integer :: idir\n")
+   file.write("\n")
+   file.write("! Set name\n")
+   file.write("@:set_name(gc99_fit_dir)\n")
+   file.write("\n")
+   file.write("! Probe in\n")
+   file.write("@:probe_in()\n")
+   file.write("\n")
+   file.write("select case (dir)\n")
+   file.write("case ('hor')\n")
+   file.write("   idir = fit_hor\n")
+   file.write("case ('ver')\n")
+   file.write("   idir = fit_ver\n")
+   file.write("case default\n")
+   file.write("   call mpl%abort('${subr}$','wrong direction: '//dir)\n")
+   file.write("end select\n")
+   file.write("\n")
+   file.write("! Probe out\n")
+   file.write("@:probe_out()\n")
+   file.write("\n")
+   file.write("end function gc99_fit_dir\n")
+   file.write("\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("! Function: gc99_fit_func_tab\n")
+   file.write("!> Fit function interpolated in the tabulated values, without bounds check\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("elemental function gc99_fit_func_tab(idir,nd) result(value)\n")
+   file.write("\n")
+   file.write("! Passed variables\n")
+   file.write("integer,intent(in) :: idir         !< Direction index\n")
+   file.write("real(kind_real),intent(in) :: nd   !< Normalized distance\n")
    file.write("\n")
    file.write("! Returned variable\n")
    file.write("real(kind_real) :: value\n")
    file.write("\n")
    file.write("! Local variables\n")
-   file.write("integer :: indm,indp\n")
-   file.write("real(kind_real) :: rndm,rndp\n")
+   file.write("integer :: itab\n")
+   file.write("real(kind_real) :: x,r\n")
+   file.write("\n")
+   file.write("! Position in the table (normalized distances beyond the support give the last value, zero)\n")
+   file.write("x = min(max(nd,ndmin),ndmax)/dnd\n")
+   file.write("itab = min(int(x),nnd-2)+1\n")
+   file.write("r = x-real(itab-1,kind_real)\n")
+   file.write("\n")
+   file.write("! Interpolated value\n")
+   file.write("value = (one-r)*func_tab(itab,idir)+r*func_tab(itab+1,idir)\n")
+   file.write("\n")
+   file.write("end function gc99_fit_func_tab\n")
+   file.write("\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("! Function: gc99_fit_func\n")
+   file.write("!> Fit function\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("function gc99_fit_func(mpl,idir,nd) result(value)\n")
+   file.write("\n")
+   file.write("! Passed variables\n")
+   file.write("type(mpl_type),intent(inout) :: mpl !< MPI data\n")
+   file.write("integer,intent(in) :: idir          !< Direction index\n")
+   file.write("real(kind_real),intent(in) :: nd    !< Normalized distance\n")
+   file.write("\n")
+   file.write("! Returned variable\n")
+   file.write("real(kind_real) :: value\n")
    file.write("\n")
    file.write("! Set name\n")
    file.write("@:set_name(gc99_fit_func)\n")
@@ -250,50 +315,51 @@ if run_horizontal and run_vertical:
    file.write("! Probe in\n")
    file.write("@:probe_in()\n")
    file.write("\n")
-   file.write("! Check bounds\n")
+   file.write("! Check direction and bounds\n")
+   file.write("if ((idir/=fit_hor).and.(idir/=fit_ver)) call mpl%abort('${subr}$','wrong direction index')\n")
    file.write("if (inf(nd,zero)) call mpl%abort('${subr}$','negative normalized distance')\n")
    file.write("\n")
-   file.write("! Initialization\n")
-   file.write("value = zero\n")
+   file.write("! Interpolated value\n")
+   file.write("value = gc99_fit_func_tab(idir,nd)\n")
    file.write("\n")
-   file.write("if (eq(nd,zero)) then\n")
-   file.write("   ! Origin\n")
-   file.write("   value = one\n")
-   file.write("elseif (infeq(nd,one)) then\n")
-   file.write("   ! Inside support\n")
+   file.write("! Probe out\n")
+   file.write("@:probe_out()\n")
+   file.write("\n")
+   file.write("end function gc99_fit_func\n")
+   file.write("\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("! Function: gc99_fit_func_vec\n")
+   file.write("!> Fit function for a vector of normalized distances\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("function gc99_fit_func_vec(mpl,idir,nd) result(value)\n")
+   file.write("\n")
+   file.write("! Passed variables\n")
+   file.write("type(mpl_type),intent(inout) :: mpl  !< MPI data\n")
+   file.write("integer,intent(in) :: idir           !< Direction index\n")
+   file.write("real(kind_real),intent(in) :: nd(:)  !< Normalized distances\n")
+   file.write("\n")
+   file.write("! Returned variable\n")
+   file.write("real(kind_real) :: value(size(nd))\n")
+   file.write("\n")
+   file.write("! Set name\n")
+   file.write("@:set_name(gc99_fit_func_vec)\n")
    file.write("\n")
-   file.write("   ! Indices\n")
-   file.write("   indm = floor(nd/dnd)+1\n")
-   file.write("   if (indm==nnd) then\n")
-   file.write("      indp = indm\n")
-   file.write("   else\n")
-   file.write("      indp = indm+1\n")
-   file.write("   end if\n")
-   file.write("\n")
-   file.write("   ! Coefficients\n")
-   file.write("   if (indm==nnd) then\n")
-   file.write("      rndm = one\n")
-   file.write("   else\n")
-   file.write("      rndm = real(indp-1,kind_real)-nd/dnd\n")
-   file.write("   end if\n")
-   file.write("   rndp = (one-rndm)\n")
-   file.write("\n")
-   file.write("   ! Interpolated value\n")
-   file.write("   if (dir=='hor') then\n")
-   file.write("      ! Horizontal fit function\n")
-   file.write("      value = rndm*func_hor(indm)+rndp*func_hor(indp)\n")
-   file.write("   elseif (dir=='ver') then\n")
-   file.write("      ! Vertical fit function\n")
-   file.write("      value = rndm*func_ver(indm)+rndp*func_ver(indp)\n")
-   file.write("   else\n")
-   file.write("      call mpl%abort('${subr}$','wrong direction: '//dir)\n")
-   file.write("   end if\n")
+   file.write("! Probe in\n")
+   file.write("@:probe_in()\n")
+   file.write("\n")
+   file.write("! Check direction and bounds\n")
+   file.write("if ((idir/=fit_hor).and.(idir/=fit_ver)) call mpl%abort('${subr}$','wrong direction index')\n")
+   file.write("if (size(nd)>0) then\n")
+   file.write("   if (inf(minval(nd),zero)) call mpl%abort('${subr}$','negative normalized distance')\n")
    file.write("end if\n")
    file.write("\n")
+   file.write("! Interpolated values\n")
+   file.write("value = gc99_fit_func_tab(idir,nd)\n")
+   file.write("\n")
    file.write("! Probe out\n")
    file.write("@:probe_out()\n")
    file.write("\n")
-   file.write("end function gc99_fit_func\n")
+   file.write("end function gc99_fit_func_vec\n")
    file.write("\n")
    file.write("!----------------------------------------------------------------------\n")
    file.write("! Function: gc99_fit_func_sqrt\n")
@@ -333,6 +399,38 @@ if run_horizontal and run_vertical:
    file.write("\n")
    file.write("end function gc99_fit_func_sqrt\n")
    file.write("\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("! Function: gc99_fit_func_sqrt_vec\n")
+   file.write("!> Fit function function square-root for a vector of normalized distances\n")
+   file.write("!----------------------------------------------------------------------\n")
+   file.write("function gc99_fit_func_sqrt_vec(mpl,nd) result(value)\n")
+   file.write("\n")
+   file.write("! Passed variables\n")
+   file.write("type(mpl_type),intent(inout) :: mpl  !< MPI data\n")
+   file.write("real(kind_real),intent(in) :: nd(:)  !< Normalized distances\n")
+   file.write("\n")
+   file.write("! Returned variable\n")
+   file.write("real(kind_real) :: value(size(nd))\n")
+   file.write("\n")
+   file.write("! Set name\n")
+   file.write("@:set_name(gc99_fit_func_sqrt_vec)\n")
+   file.write("\n")
+   file.write("! Probe in\n")
+   file.write("@:probe_in()\n")
+   file.write("\n")
+   file.write("! Check bounds\n")
+   file.write("if (size(nd)>0) then\n")
+   file.write("   if (inf(minval(nd),zero)) call mpl%abort('${subr}$','negative normalized distance')\n")
+   file.write("end if\n")
+   file.write("\n")
+   file.write("! Branch-free evaluation, zero outside of the support\n")
+   file.write("value = max(one-two*max(nd,zero),zero)\n")
+   file.write("\n")
+   file.write("! Probe out\n")
+   file.write("@:probe_out()\n")
+   file.write("\n")
+   file.write("end function gc99_fit_func_sqrt_vec\n")
+   file.write("\n")
    file.write("end module tools_gc99\n")
 
    # Close file
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Example: python saber_nicas_cache_check.py ${build}/saber/test/testdata/bump_nicas/nicas_cache_000004.bin
+"""! NICAS binary cache validation script"""
+
+import argparse
+import sys
+import numpy as np
+
+# Parser
+parser = argparse.ArgumentParser()
+parser.add_argument("filename", help="NICAS binary cache file")
+parser.add_argument("--no-checksum", action="store_true", help="Skip segments checksums")
+args = parser.parse_args()
+
+# Format parameters (see type_nicas.fypp)
+magic = np.frombuffer(b"BUMPNICA", dtype=np.int64)[0]
+version = 1
+nhead_glb = 8
+nhead_proc = 8
+align = 4096
+
+def fletcher32(data):
+   """! Fletcher-32 checksum, identical to tools_func.c"""
+   words = np.frombuffer(data, dtype=np.uint16).astype(np.uint64)
+   sum1 = 0xffff
+   sum2 = 0xffff
+   for start in range(0, len(words), 359):
+      block = words[start:start+359]
+      n = len(block)
+      sum2 += n*sum1+int(np.dot(np.arange(n, 0, -1, dtype=np.uint64), block))
+      sum1 += int(block.sum())
+      sum1 = (sum1 & 0xffff)+(sum1 >> 16)
+      sum2 = (sum2 & 0xffff)+(sum2 >> 16)
+   sum1 = (sum1 & 0xffff)+(sum1 >> 16)
+   sum2 = (sum2 & 0xffff)+(sum2 >> 16)
+   return ((sum2 << 16) | sum1) & 0xffffffff
+
+# Read file
+with open(args.filename, "rb") as f:
+   raw = f.read()
+errors = []
+
+# Global header
+if len(raw) < 8*nhead_glb:
+   sys.exit("File too small for a NICAS cache header")
+head = np.frombuffer(raw, dtype=np.int64, count=nhead_glb)
+if head[0] != magic:
+   sys.exit("Wrong magic number or byte order")
+if head[1] != version:
+   sys.exit("Unsupported version: " + str(head[1]))
+nproc = int(head[2])
+size_r, size_i, size_l = int(head[4]), int(head[5]), int(head[6])
+print("Version:           " + str(head[1]))
+print("Number of tasks:   " + str(nproc))
+print("NICAS blocks:      " + str(head[3]))
+print("Levels:            " + str(head[7]))
+print("Sizes (r / i / l): " + str(size_r) + " / " + str(size_i) + " / " + str(size_l))
+
+# Tasks headers
+nhead = nhead_glb+nhead_proc*nproc
+if len(raw) < 8*nhead:
+   sys.exit("File too small for the tasks headers")
+table = np.frombuffer(raw, dtype=np.int64, count=nhead)[nhead_glb:].reshape(nproc, nhead_proc)
+end = 8*nhead
+for iproc in range(nproc):
+   offset, nbufr, nbufi, nbufl, nc0a = [int(v) for v in table[iproc, 0:5]]
+   cksum = [int(v) & 0xffffffff for v in table[iproc, 5:8]]
+   nbytes = [nbufr*size_r, nbufi*size_i, nbufl*size_l]
+   line = "Task " + str(iproc+1).rjust(6) + ": offset " + str(offset).rjust(12) + ", nc0a " + str(nc0a).rjust(8) \
+      + ", buffers " + str(nbufr) + " / " + str(nbufi) + " / " + str(nbufl)
+
+   # Layout
+   if offset % align != 0:
+      errors.append("task " + str(iproc+1) + ": misaligned segment offset")
+   if offset < end:
+      errors.append("task " + str(iproc+1) + ": overlapping segments")
+   if offset+sum(nbytes) > len(raw):
+      errors.append("task " + str(iproc+1) + ": truncated segments")
+      print(line)
+      continue
+   end = offset+sum(nbytes)
+
+   # Checksums
+   if not args.no_checksum:
+      for iseg, name in enumerate(["real", "integer", "logical"]):
+         if nbytes[iseg] > 0 and fletcher32(raw[offset:offset+nbytes[iseg]]) != cksum[iseg]:
+            errors.append("task " + str(iproc+1) + ": wrong checksum for the " + name + " segment")
+         offset += nbytes[iseg]
+   print(line)
+
+# Summary
+if errors:
+   for error in errors:
+      print("Error: " + error)
+   sys.exit(1)
+print("NICAS cache is valid")